@@ -0,0 +1,248 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "../Graphics/AtlasPacker.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Replays a trace of bitmap sizes against every atlas packer and reports how well each fills the atlas
+// A trace is recorded by the client with the 'AtlasTrace' setting: one "width height" line per bitmap and
+// a "clear" line on every map change, lines starting with '#' are ignored
+// Usage: AtlasBenchmark <trace> [page width] [page height] [pages] [repeat]
+namespace ms {
+    namespace {
+        struct Upload {
+            int16_t width;
+            int16_t height;
+        };
+
+        // The bitmaps loaded for one map
+        using Map = std::vector<Upload>;
+
+        struct Result {
+            size_t uploads = 0;
+            size_t rejected = 0;
+            size_t evictions = 0;
+            size_t inserts = 0;
+            int64_t insert_time = 0;
+            // Summed over every map change
+            double fill = 0.0;
+            double wasted = 0.0;
+            size_t samples = 0;
+        };
+
+        const char* const NAMES[AtlasPacker::Type::NUM_TYPES] = {
+            "Leftover", "Skyline"
+        };
+
+        bool read_trace(const std::string& path, std::vector<Map>& maps) {
+            std::ifstream file(path);
+
+            if (!file.is_open())
+                return false;
+
+            maps.emplace_back();
+
+            std::string line;
+
+            while (std::getline(file, line)) {
+                if (line.empty() || line[0] == '#')
+                    continue;
+
+                if (line.compare(0, 5, "clear") == 0) {
+                    if (!maps.back().empty())
+                        maps.emplace_back();
+
+                    continue;
+                }
+
+                std::istringstream stream(line);
+                int width = 0;
+                int height = 0;
+
+                if (stream >> width >> height)
+                    maps.back().push_back({ static_cast<int16_t>(width), static_cast<int16_t>(height) });
+            }
+
+            if (maps.back().empty())
+                maps.pop_back();
+
+            return true;
+        }
+
+        // Mirrors how 'GraphicsGL' spreads bitmaps over its pages: the first page with space is used, if none has space the
+        // least recently used page is evicted, and pages which are mostly full are evicted on a map change
+        class Atlas {
+        public:
+            Atlas(AtlasPacker::Type type, int16_t width, int16_t height, size_t count) : lastused(count, 0), clock(0) {
+                for (size_t i = 0; i < count; i++)
+                    pages.push_back(AtlasPacker::create(type, width, height));
+
+                area = static_cast<double>(width) * height * count;
+            }
+
+            void upload(Upload bitmap, Result& result) {
+                result.uploads++;
+                clock++;
+
+                Point<int16_t> position;
+
+                for (size_t i = 0; i < pages.size(); i++) {
+                    if (pages[i]->insert(bitmap.width, bitmap.height, position)) {
+                        lastused[i] = clock;
+                        return;
+                    }
+                }
+
+                size_t oldest = 0;
+
+                for (size_t i = 1; i < pages.size(); i++)
+                    if (lastused[i] < lastused[oldest])
+                        oldest = i;
+
+                pages[oldest]->clear();
+                result.evictions++;
+
+                if (pages[oldest]->insert(bitmap.width, bitmap.height, position))
+                    lastused[oldest] = clock;
+                else
+                    result.rejected++;
+            }
+
+            void change_map(Result& result) {
+                sample(result);
+
+                for (auto& page : pages) {
+                    if (page->get_fill() > CLEARFILL) {
+                        page->clear();
+                        result.evictions++;
+                    }
+                }
+            }
+
+            void sample(Result& result) const {
+                size_t used = 0;
+                size_t wasted = 0;
+
+                for (const auto& page : pages) {
+                    used += page->get_used();
+                    wasted += page->get_wasted();
+                }
+
+                result.fill += used / area;
+                result.wasted += wasted / area;
+                result.samples++;
+            }
+
+            void finish(Result& result) const {
+                for (const auto& page : pages) {
+                    result.inserts += page->get_inserts();
+                    result.insert_time += page->get_insert_time();
+                }
+            }
+
+        private:
+            static constexpr double CLEARFILL = 0.8;
+
+            std::vector<std::unique_ptr<AtlasPacker>> pages;
+            std::vector<size_t> lastused;
+            size_t clock;
+            double area;
+        };
+
+        Result replay(AtlasPacker::Type type, const std::vector<Map>& maps, int16_t width, int16_t height, size_t count, size_t repeat) {
+            Result result;
+            Atlas atlas(type, width, height, count);
+
+            for (size_t r = 0; r < repeat; r++) {
+                for (const Map& map : maps) {
+                    for (Upload bitmap : map)
+                        atlas.upload(bitmap, result);
+
+                    atlas.change_map(result);
+                }
+            }
+
+            atlas.finish(result);
+
+            return result;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace ms;
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <trace> [page width] [page height] [pages] [repeat]" << std::endl;
+        return 1;
+    }
+
+    // The defaults are about the size of an atlas page in the client
+    int16_t width = static_cast<int16_t>(argc > 2 ? std::stoi(argv[2]) : 8192);
+    int16_t height = static_cast<int16_t>(argc > 3 ? std::stoi(argv[3]) : 1920);
+    size_t count = argc > 4 ? std::stoul(argv[4]) : 4;
+    size_t repeat = argc > 5 ? std::stoul(argv[5]) : 10;
+
+    std::vector<Map> maps;
+
+    if (!read_trace(argv[1], maps) || maps.empty()) {
+        std::cerr << "Could not read a trace from " << argv[1] << std::endl;
+        return 1;
+    }
+
+    size_t bitmaps = 0;
+
+    for (const Map& map : maps)
+        bitmaps += map.size();
+
+    std::cout << "Trace " << argv[1] << ": " << bitmaps << " bitmaps over " << maps.size() << " maps, replayed "
+        << repeat << " times into " << count << " pages of " << width << "x" << height << std::endl;
+
+    std::cout << std::left << std::setw(10) << "Packer"
+        << std::right << std::setw(10) << "Uploads"
+        << std::setw(10) << "Rejected"
+        << std::setw(11) << "Evictions"
+        << std::setw(9) << "Fill %"
+        << std::setw(10) << "Waste %"
+        << std::setw(12) << "ns/insert" << std::endl;
+
+    for (uint8_t i = 0; i < AtlasPacker::Type::NUM_TYPES; i++) {
+        auto type = static_cast<AtlasPacker::Type>(i);
+        Result result = replay(type, maps, width, height, count, repeat);
+
+        // Fill and waste are averaged over the map changes, just before mostly full pages are evicted
+        double fill = result.samples > 0 ? 100.0 * result.fill / result.samples : 0.0;
+        double wasted = result.samples > 0 ? 100.0 * result.wasted / result.samples : 0.0;
+        double time = result.inserts > 0 ? static_cast<double>(result.insert_time) / result.inserts : 0.0;
+
+        std::cout << std::left << std::setw(10) << NAMES[i]
+            << std::right << std::setw(10) << result.uploads
+            << std::setw(10) << result.rejected
+            << std::setw(11) << result.evictions
+            << std::fixed << std::setprecision(1)
+            << std::setw(9) << fill
+            << std::setw(10) << wasted
+            << std::setw(12) << time << std::endl;
+    }
+
+    return 0;
+}
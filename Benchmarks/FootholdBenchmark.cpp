@@ -0,0 +1,361 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "../Gameplay/Physics/FootholdTree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+// Builds the per-pixel foothold multimap the client used before and the column index of 'FootholdTree' from the
+// same generated map, then checks that both answer the same queries and compares their timings
+// Usage: FootholdBenchmark [map width] [platform rows] [queries] [seed]
+namespace ms {
+    namespace {
+        constexpr int16_t L_OFFSET = 30;
+        constexpr int16_t R_OFFSET = -30;
+        constexpr int16_t T_OFFSET = -300;
+        constexpr int16_t B_OFFSET = 100;
+
+        // The lookups of 'FootholdTree' before it was indexed by columns
+        class MultimapTree {
+        public:
+            MultimapTree(const std::vector<Foothold>& source) {
+                int16_t leftw = 30000;
+                int16_t rightw = -30000;
+                int16_t botb = -30000;
+                int16_t topb = 30000;
+
+                for (const Foothold& fh : source) {
+                    if (!footholds.emplace(fh.id(), fh).second)
+                        continue;
+
+                    leftw = std::min(leftw, fh.l());
+                    rightw = std::max(rightw, fh.r());
+                    botb = std::max(botb, fh.b());
+                    topb = std::min(topb, fh.t());
+
+                    if (fh.is_wall())
+                        continue;
+
+                    for (int16_t i = fh.l(); i <= fh.r(); i++)
+                        footholdsbyx.emplace(i, fh.id());
+                }
+
+                walls = Range<int16_t>(leftw + L_OFFSET, rightw + R_OFFSET);
+                borders = Range<int16_t>(topb + T_OFFSET, botb + B_OFFSET);
+            }
+
+            size_t entries() const {
+                return footholdsbyx.size();
+            }
+
+            const Foothold& get_fh(uint16_t fhid) const {
+                auto iter = footholds.find(fhid);
+
+                if (iter == footholds.end())
+                    return nullfh;
+
+                return iter->second;
+            }
+
+            double get_wall(uint16_t curid, bool left, double fy) const {
+                auto shorty = static_cast<int16_t>(fy);
+                Range<int16_t> vertical(shorty - 50, shorty - 1);
+                const Foothold& cur = get_fh(curid);
+
+                if (left) {
+                    const Foothold& prev = get_fh(cur.prev());
+
+                    if (prev.is_blocking(vertical))
+                        return cur.l();
+
+                    const Foothold& prev_prev = get_fh(prev.prev());
+
+                    if (prev_prev.is_blocking(vertical))
+                        return prev.l();
+
+                    return walls.first();
+                }
+
+                const Foothold& next = get_fh(cur.next());
+
+                if (next.is_blocking(vertical))
+                    return cur.r();
+
+                const Foothold& next_next = get_fh(next.next());
+
+                if (next_next.is_blocking(vertical))
+                    return next.r();
+
+                return walls.second();
+            }
+
+            double get_edge(uint16_t curid, bool left) const {
+                const Foothold& fh = get_fh(curid);
+
+                if (left) {
+                    uint16_t previd = fh.prev();
+
+                    if (!previd)
+                        return fh.l();
+
+                    const Foothold& prev = get_fh(previd);
+
+                    if (!prev.prev())
+                        return prev.l();
+
+                    return walls.first();
+                }
+
+                uint16_t nextid = fh.next();
+
+                if (!nextid)
+                    return fh.r();
+
+                const Foothold& next = get_fh(nextid);
+
+                if (!next.next())
+                    return next.r();
+
+                return walls.second();
+            }
+
+            uint16_t get_fhid_below(double fx, double fy) const {
+                uint16_t ret = 0;
+                double comp = borders.second();
+
+                int16_t x = static_cast<int16_t>(fx);
+                auto range = footholdsbyx.equal_range(x);
+
+                for (auto iter = range.first; iter != range.second; ++iter) {
+                    const Foothold& fh = footholds.at(iter->second);
+                    double ycomp = fh.ground_below(fx);
+
+                    if (comp >= ycomp && ycomp >= fy) {
+                        comp = ycomp;
+                        ret = fh.id();
+                    }
+                }
+
+                return ret;
+            }
+
+        private:
+            std::unordered_map<uint16_t, Foothold> footholds;
+            std::unordered_multimap<int16_t, uint16_t> footholdsbyx;
+            Foothold nullfh;
+            Range<int16_t> walls;
+            Range<int16_t> borders;
+        };
+
+        // Generates rows of connected platforms with slopes, gaps and walls at the ends of each chain
+        std::vector<Foothold> generate(int16_t width, int16_t rows, std::mt19937& random) {
+            std::vector<Foothold> footholds;
+            uint16_t nextid = 1;
+
+            std::uniform_int_distribution<int> length(30, 300);
+            std::uniform_int_distribution<int> rise(-40, 40);
+            std::uniform_int_distribution<int> chance(0, 99);
+
+            for (int16_t row = 0; row < rows; row++) {
+                int16_t y = static_cast<int16_t>(-row * 120);
+                int16_t x = static_cast<int16_t>(-width / 2);
+                int16_t right = static_cast<int16_t>(width / 2);
+                uint8_t layer = static_cast<uint8_t>(row % 8);
+
+                while (x < right) {
+                    // Upper rows have gaps between their chains
+                    if (row > 0 && chance(random) < 30)
+                        x = static_cast<int16_t>(x + length(random));
+
+                    std::vector<Foothold> chain;
+                    size_t segments = 1 + chance(random) % 12;
+
+                    // A wall rising from the left end of the chain
+                    chain.emplace_back(0, 0, 0, layer, Range<int16_t>(x, x), Range<int16_t>(y - 60, y));
+
+                    for (size_t i = 0; i < segments && x < right; i++) {
+                        int16_t x2 = std::min<int16_t>(right, static_cast<int16_t>(x + length(random)));
+                        int16_t y2 = chance(random) < 40 ? static_cast<int16_t>(y + rise(random)) : y;
+
+                        chain.emplace_back(0, 0, 0, layer, Range<int16_t>(x, x2), Range<int16_t>(y, y2));
+
+                        x = x2;
+                        y = y2;
+                    }
+
+                    chain.emplace_back(0, 0, 0, layer, Range<int16_t>(x, x), Range<int16_t>(y, y - 60));
+
+                    // Link the chain, the walls at its ends have no outer neighbours
+                    for (size_t i = 0; i < chain.size(); i++) {
+                        uint16_t id = static_cast<uint16_t>(nextid + i);
+                        uint16_t prev = i > 0 ? static_cast<uint16_t>(id - 1) : 0;
+                        uint16_t next = i + 1 < chain.size() ? static_cast<uint16_t>(id + 1) : 0;
+
+                        footholds.emplace_back(id, prev, next, layer, chain[i].horizontal(), chain[i].vertical());
+                    }
+
+                    nextid = static_cast<uint16_t>(nextid + chain.size());
+                    y = static_cast<int16_t>(-row * 120);
+                }
+            }
+
+            return footholds;
+        }
+
+        using Clock = std::chrono::steady_clock;
+
+        double elapsed_ms(Clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        double per_query_ns(double ms, size_t count) {
+            return count > 0 ? ms * 1000000.0 / count : 0.0;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace ms;
+
+    int16_t width = static_cast<int16_t>(argc > 1 ? std::stoi(argv[1]) : 12000);
+    int16_t rows = static_cast<int16_t>(argc > 2 ? std::stoi(argv[2]) : 12);
+    size_t queries = argc > 3 ? std::stoul(argv[3]) : 1000000;
+    uint32_t seed = argc > 4 ? static_cast<uint32_t>(std::stoul(argv[4])) : 1;
+
+    std::mt19937 random(seed);
+    std::vector<Foothold> footholds = generate(width, rows, random);
+
+    auto start = Clock::now();
+    MultimapTree multimap(footholds);
+    double multimap_build = elapsed_ms(start);
+
+    start = Clock::now();
+    FootholdTree columns(footholds);
+    double columns_build = elapsed_ms(start);
+
+    std::cout << footholds.size() << " footholds in " << rows << " rows over " << width << " px, "
+        << multimap.entries() << " multimap entries" << std::endl;
+
+    // Queries are spread over the whole map, including positions left and right of all platforms
+    Range<int16_t> borders = columns.get_borders();
+
+    std::uniform_real_distribution<double> query_x(-width / 2 - 100.0, width / 2 + 100.0);
+    std::uniform_real_distribution<double> query_y(borders.first(), borders.second());
+    std::vector<std::pair<double, double>> positions(queries);
+
+    for (auto& position : positions)
+        position = { query_x(random), query_y(random) };
+
+    std::vector<uint16_t> expected(queries);
+    std::vector<uint16_t> actual(queries);
+
+    start = Clock::now();
+
+    for (size_t i = 0; i < queries; i++)
+        expected[i] = multimap.get_fhid_below(positions[i].first, positions[i].second);
+
+    double multimap_below = elapsed_ms(start);
+    start = Clock::now();
+
+    for (size_t i = 0; i < queries; i++)
+        actual[i] = columns.get_fhid_below(positions[i].first, positions[i].second);
+
+    double columns_below = elapsed_ms(start);
+
+    size_t below_mismatches = 0;
+    size_t ties = 0;
+
+    for (size_t i = 0; i < queries; i++) {
+        if (expected[i] == actual[i])
+            continue;
+
+        // Connected platforms share their end points, either one is correct if the ground is at the same height
+        double x = positions[i].first;
+
+        if (expected[i] && actual[i] && multimap.get_fh(expected[i]).ground_below(x) == multimap.get_fh(actual[i]).ground_below(x))
+            ties++;
+        else
+            below_mismatches++;
+    }
+
+    // Every platform is queried for walls and edges on both sides
+    std::uniform_int_distribution<int> wall_y(-40, 40);
+    std::vector<std::pair<uint16_t, double>> sides;
+
+    for (const Foothold& fh : footholds)
+        if (!fh.is_wall())
+            sides.emplace_back(fh.id(), fh.ground_below(fh.l()) + wall_y(random));
+
+    size_t side_queries = sides.size() * 2;
+    std::vector<double> expected_sides(side_queries * 2);
+    std::vector<double> actual_sides(side_queries * 2);
+
+    start = Clock::now();
+
+    for (size_t i = 0; i < sides.size(); i++) {
+        for (size_t left = 0; left < 2; left++) {
+            expected_sides[i * 4 + left * 2] = multimap.get_wall(sides[i].first, left != 0, sides[i].second);
+            expected_sides[i * 4 + left * 2 + 1] = multimap.get_edge(sides[i].first, left != 0);
+        }
+    }
+
+    double multimap_sides = elapsed_ms(start);
+    start = Clock::now();
+
+    for (size_t i = 0; i < sides.size(); i++) {
+        for (size_t left = 0; left < 2; left++) {
+            actual_sides[i * 4 + left * 2] = columns.get_wall(sides[i].first, left != 0, sides[i].second);
+            actual_sides[i * 4 + left * 2 + 1] = columns.get_edge(sides[i].first, left != 0);
+        }
+    }
+
+    double columns_sides = elapsed_ms(start);
+
+    size_t side_mismatches = 0;
+
+    for (size_t i = 0; i < expected_sides.size(); i++)
+        if (expected_sides[i] != actual_sides[i])
+            side_mismatches++;
+
+    std::cout << std::left << std::setw(10) << "Index"
+        << std::right << std::setw(12) << "Build ms"
+        << std::setw(14) << "Below ns"
+        << std::setw(18) << "Wall+edge ns" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(1);
+
+    std::cout << std::left << std::setw(10) << "Multimap"
+        << std::right << std::setw(12) << multimap_build
+        << std::setw(14) << per_query_ns(multimap_below, queries)
+        << std::setw(18) << per_query_ns(multimap_sides, side_queries) << std::endl;
+
+    std::cout << std::left << std::setw(10) << "Columns"
+        << std::right << std::setw(12) << columns_build
+        << std::setw(14) << per_query_ns(columns_below, queries)
+        << std::setw(18) << per_query_ns(columns_sides, side_queries) << std::endl;
+
+    std::cout << queries << " below queries: " << below_mismatches << " mismatches, " << ties << " ties between connected platforms" << std::endl;
+    std::cout << side_queries << " wall and edge queries: " << side_mismatches << " mismatches" << std::endl;
+
+    return below_mismatches == 0 && side_mismatches == 0 ? 0 : 1;
+}
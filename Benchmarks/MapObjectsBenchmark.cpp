@@ -0,0 +1,187 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "../Constants.h"
+
+#include "../Gameplay/MapleMap/MapObjects.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Replays a spawn, move and kill trace against 'MapObjects' and reports the time per tick
+// The trace follows the script of 'Simulation': mobs respawn in waves, move every few ticks and leave a drop when killed,
+// but every mob has its own wave offset so that objects are added and removed in the middle of the collections
+// Every tick the mobs and drops are updated, drawn on all layers and searched for the closest mobs like an attack does
+// The trace is replayed several times and every replay has to draw and target the same objects
+// Usage: MapObjectsBenchmark [mobs] [ticks]
+namespace ms {
+    namespace {
+        // Mobs are moved every this many ticks, staggered by their oid
+        constexpr uint32_t MOVE_INTERVAL = 30;
+        // Every mob is killed and respawned every this many ticks
+        constexpr uint32_t WAVE_INTERVAL = 600;
+        // Oids of drops are offset from the oids of the mobs dropping them
+        constexpr int32_t DROP_OIDS = 1000000;
+        // The width of the map the objects are spread over
+        constexpr int16_t MAPWIDTH = 4000;
+        // The number of times the trace is replayed
+        constexpr size_t RUNS = 3;
+
+        // Sum of the positions of all objects drawn, which must be the same for every replay
+        int64_t drawsum = 0;
+
+        // A map object which walks towards the position it was last moved to
+        class TraceObject : public MapObject {
+        public:
+            TraceObject(int32_t oid, Point<int16_t> position) : MapObject(oid, position), destination(position) {
+                physics_object.fh_layer = static_cast<uint8_t>(oid % Layer::Id::LENGTH);
+            }
+
+            void draw(double, double, float) const override {
+                drawsum += get_position().x() + get_position().y();
+            }
+
+            bool update_before_move(const Physics&) override {
+                Point<int16_t> position = get_position();
+                int16_t step = std::max<int16_t>(-2, std::min<int16_t>(2, destination.x() - position.x()));
+
+                set_position(position.x() + step, position.y());
+
+                return false;
+            }
+
+            Rectangle<int16_t> get_bounds() const override {
+                Point<int16_t> position = get_position();
+
+                return Rectangle<int16_t>(position.x() - 30, position.x() + 30, position.y() - 60, position.y());
+            }
+
+            void move_to(Point<int16_t> position) {
+                destination = position;
+            }
+
+        private:
+            Point<int16_t> destination;
+        };
+
+        uint32_t hash(int32_t oid, uint32_t tick) {
+            return static_cast<uint32_t>(oid) * 2654435761u + tick * 40503u;
+        }
+
+        Point<int16_t> position_of(int32_t oid, uint32_t tick) {
+            return { static_cast<int16_t>(hash(oid, tick) % MAPWIDTH - MAPWIDTH / 2), 0 };
+        }
+
+        struct Result {
+            double ms = 0.0;
+            size_t ops = 0;
+            size_t targets = 0;
+            int64_t drawn = 0;
+            size_t mobs = 0;
+            size_t drops = 0;
+        };
+
+        // Run the trace starting from an empty map
+        Result replay(int32_t num_mobs, uint32_t ticks) {
+            MapObjects mobs;
+            MapObjects drops;
+            Physics physics;
+            Result result;
+
+            drawsum = 0;
+
+            Rectangle<int16_t> attack(-600, 600, -200, 50);
+            auto alive = [](const MapObject& mmo) {
+                return mmo.is_active();
+            };
+
+            auto start = std::chrono::steady_clock::now();
+
+            for (uint32_t tick = 0; tick < ticks; tick++) {
+                for (int32_t oid = 1; oid <= num_mobs; oid++) {
+                    uint32_t wave = (tick + hash(oid, 0)) % WAVE_INTERVAL;
+
+                    if (wave == 0) {
+                        drops.remove(DROP_OIDS + oid);
+                        mobs.add(std::make_unique<TraceObject>(oid, position_of(oid, tick)));
+                        result.ops += 2;
+                    } else if (wave == WAVE_INTERVAL - 1) {
+                        if (Optional<MapObject> mob = mobs.get(oid))
+                            drops.add(std::make_unique<TraceObject>(DROP_OIDS + oid, mob->get_position()));
+
+                        mobs.remove(oid);
+                        result.ops += 2;
+                    } else if ((wave + oid) % MOVE_INTERVAL == 0) {
+                        if (Optional<MapObject> mob = mobs.get(oid))
+                            static_cast<TraceObject*>(mob.get())->move_to(position_of(oid, tick));
+
+                        result.ops++;
+                    }
+                }
+
+                mobs.update_batched(physics);
+                drops.update_batched(physics);
+
+                for (auto layer : Layer::IDs) {
+                    mobs.draw(layer, 1024.0, 400.0, 1.0f);
+                    drops.draw(layer, 1024.0, 400.0, 1.0f);
+                }
+
+                result.targets += mobs.find_closest(attack, Point<int16_t>(0, 0), 6, alive).size();
+            }
+
+            result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            result.drawn = drawsum;
+            result.mobs = mobs.size();
+            result.drops = drops.size();
+
+            return result;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace ms;
+
+    auto num_mobs = static_cast<int32_t>(argc > 1 ? std::stoi(argv[1]) : 500);
+    auto ticks = static_cast<uint32_t>(argc > 2 ? std::stoul(argv[2]) : 3000);
+
+    // Keep the fastest run
+    Result fastest;
+    bool same = true;
+
+    for (size_t run = 0; run < RUNS; run++) {
+        Result result = replay(num_mobs, ticks);
+
+        if (run > 0)
+            same = same && result.drawn == fastest.drawn && result.targets == fastest.targets &&
+                   result.mobs == fastest.mobs && result.drops == fastest.drops;
+
+        if (run == 0 || result.ms < fastest.ms)
+            fastest = result;
+    }
+
+    std::cout << num_mobs << " mobs over " << ticks << " ticks, " << fastest.ops << " spawn, move and kill operations" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Total: " << fastest.ms << " ms, " << fastest.ms * 1000.0 / ticks << " us per tick" << std::endl;
+    std::cout << "Left: " << fastest.mobs << " mobs, " << fastest.drops << " drops" << std::endl;
+    std::cout << (same ? "Every replay drew and targeted the same objects" : "The replays differ") << std::endl;
+
+    return same ? 0 : 1;
+}
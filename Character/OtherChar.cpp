@@ -24,37 +24,26 @@ namespace ms {
                          int8_t stance, Point<int16_t> position) : Char(charid, look, name), level(level), job(job) {
         set_position(position);
 
-        lastmove.xpos = position.x();
-        lastmove.ypos = position.y();
-        lastmove.newstate = stance;
-        timer = 0;
+        movements.reset(position, stance);
 
         attackspeed = 6;
         attacking = false;
     }
 
     int8_t OtherChar::update(const Physics& physics) {
-        if (timer > 1) {
-            timer--;
-        } else if (timer == 1) {
-            if (!movements.empty()) {
-                lastmove = movements.front();
-                movements.pop();
-            } else {
-                timer = 0;
-            }
-        }
-
-        if (!attacking) {
-            uint8_t laststate = lastmove.newstate;
-            set_state(laststate);
-        }
-
-        physics_object.h_speed = lastmove.xpos - physics_object.current_x();
-        physics_object.v_speed = lastmove.ypos - physics_object.current_y();
+        bool moved = movements.update();
+
+        if (!attacking)
+            set_state(movements.get_state());
+
+        Point<double> position = movements.get_position();
+        physics_object.h_speed = position.x() - physics_object.current_x();
+        physics_object.v_speed = position.y() - physics_object.current_y();
         physics_object.move();
 
-        physics.get_fht().update_fh(physics_object);
+        // The platform only changes when the character moved
+        if (moved)
+            physics.get_fht().update_fh(physics_object);
 
         bool aniend = Char::update(physics, get_stance_speed());
 
@@ -65,12 +54,7 @@ namespace ms {
     }
 
     void OtherChar::send_movement(const std::vector<Movement>& newmoves) {
-        movements.push(newmoves.back());
-
-        if (timer == 0) {
-            constexpr uint16_t DELAY = 50;
-            timer = DELAY;
-        }
+        movements.push(newmoves);
     }
 
     void OtherChar::update_skill(int32_t skillid, uint8_t skilllevel) {
@@ -84,8 +68,7 @@ namespace ms {
     void OtherChar::update_look(const LookEntry& newlook) {
         look = newlook;
 
-        uint8_t laststate = lastmove.newstate;
-        set_state(laststate);
+        set_state(movements.get_state());
     }
 
     int8_t OtherChar::get_integer_attackspeed() const {
@@ -21,9 +21,8 @@
 
 #include "Look/CharLook.h"
 
-#include "../Gameplay/Movement.h"
+#include "../Gameplay/MovementBuffer.h"
 
-#include <queue>
 #include <vector>
 
 namespace ms {
@@ -55,9 +54,7 @@ namespace ms {
     private:
         uint16_t level;
         int16_t job;
-        std::queue<Movement> movements;
-        Movement lastmove;
-        uint16_t timer;
+        MovementBuffer movements;
 
         std::unordered_map<int32_t, uint8_t> skilllevels;
         uint8_t attackspeed;
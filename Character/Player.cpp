@@ -20,6 +20,8 @@
 #include "PlayerStates.h"
 #include "SkillId.h"
 
+#include "../Configuration.h"
+
 #include "../Data/WeaponData.h"
 #include "../IO/UI.h"
 #include "../IO/UITypes/UIStatsInfo.h"
@@ -76,6 +78,8 @@ namespace ms {
         // Only start this if Endure (WARRIOR) skill is present
         hp_recovery_ladder_timer = tm.create_timer(HP_RECOVERY_LADDER_INTERVAL);
 
+        movements.set_interval(Setting<MovementInterval>::get().load());
+
         set_state(State::FALL);
         set_direction(true);
     }
@@ -91,6 +95,7 @@ namespace ms {
         ladder = nullptr;
         keysdown.clear();
         physics_object.reset_movement();
+        movements.clear();
         set_state(State::FALL);
 //        nullstate.update_state(*this);
     }
@@ -197,10 +202,15 @@ namespace ms {
             hp_recovery_ladder_timer.reset();
             hp_recovery_timer.reset();
 
-            MovePlayerPacket(newmove).dispatch();
+            movements.record(newmove);
             lastmove = newmove;
         }
 
+        if (movements.update()) {
+            MovePlayerPacket(movements.get_path()).dispatch();
+            movements.clear();
+        }
+
         climb_cooldown.update();
         portal_cooldown.update();
         try_hp_recovery();
@@ -26,6 +26,7 @@
 
 #include "Inventory/Inventory.h"
 
+#include "../Gameplay/MovementRecorder.h"
 #include "../Gameplay/Playable.h"
 
 #include "../Gameplay/Combat/Skill.h"
@@ -188,6 +189,7 @@ namespace ms {
         std::map<KeyAction::Id, bool> keysdown;
 
         Movement lastmove;
+        MovementRecorder movements;
 
         Randomizer randomizer;
 
@@ -34,6 +34,26 @@ namespace ms {
         settings.emplace<VSync>();
         settings.emplace<FontPathNormal>();
         settings.emplace<FontPathBold>();
+        settings.emplace<AtlasPackerType>();
+        settings.emplace<AtlasTrace>();
+        settings.emplace<AsyncTextures>();
+        settings.emplace<StaticBatches>();
+        settings.emplace<IndexedQuads>();
+        settings.emplace<BatchedPhysics>();
+        settings.emplace<Profiling>();
+        settings.emplace<SimulationMap>();
+        settings.emplace<SimulationMob>();
+        settings.emplace<SimulationMobs>();
+        settings.emplace<SimulationCapture>();
+        settings.emplace<SimulationSpeed>();
+        settings.emplace<SimulationTicks>();
+        settings.emplace<NetThread>();
+        settings.emplace<NetPacketBudget>();
+        settings.emplace<MovementInterval>();
+        settings.emplace<EffectLimit>();
+        settings.emplace<BulletLimit>();
+        settings.emplace<DamageNumberLimit>();
+        settings.emplace<PacketCapture>();
         settings.emplace<BGMVolume>();
         settings.emplace<SFXVolume>();
         settings.emplace<SaveLogin>();
@@ -45,6 +65,8 @@ namespace ms {
         settings.emplace<ChatViewMax>();
         settings.emplace<ChatViewX>();
         settings.emplace<ChatViewY>();
+        settings.emplace<ChatLogSize>();
+        settings.emplace<ChatTranscript>();
         settings.emplace<PosSTATS>();
         settings.emplace<PosEQINV>();
         settings.emplace<PosINV>();
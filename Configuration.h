@@ -303,6 +303,133 @@ namespace ms {
         }
     };
 
+    // The rectangle packer used for the texture atlas
+    // 0 = Leftover tree, 1 = Skyline
+    struct AtlasPackerType : Configuration::ByteEntry {
+        AtlasPackerType() : ByteEntry("AtlasPacker", "0") {
+        }
+    };
+
+    // Append the size of every bitmap added to the atlas to this file, it can be replayed by 'AtlasBenchmark'
+    // Empty disables the trace
+    struct AtlasTrace : Configuration::StringEntry {
+        AtlasTrace() : StringEntry("AtlasTrace", "") {
+        }
+    };
+
+    // Whether to decode textures on a worker thread
+    struct AsyncTextures : Configuration::BoolEntry {
+        AsyncTextures() : BoolEntry("AsyncTextures", "true") {
+        }
+    };
+
+    // Whether to keep static map tiles in vertex buffers instead of rebuilding their quads every frame
+    struct StaticBatches : Configuration::BoolEntry {
+        StaticBatches() : BoolEntry("StaticBatches", "true") {
+        }
+    };
+
+    // Whether to draw quads as indexed triangles instead of the legacy quad primitive
+    struct IndexedQuads : Configuration::BoolEntry {
+        IndexedQuads() : BoolEntry("IndexedQuads", "true") {
+        }
+    };
+
+    // Whether to receive and send packets on a separate network thread
+    struct NetThread : Configuration::BoolEntry {
+        NetThread() : BoolEntry("NetThread", "false") {
+        }
+    };
+
+    // The maximum number of packets handled per update when using the network thread
+    // Zero handles all queued packets
+    struct NetPacketBudget : Configuration::ShortEntry {
+        NetPacketBudget() : ShortEntry("NetPacketBudget", "64") {
+        }
+    };
+
+    // The milliseconds for which the player's movements are collected before they are sent in one packet
+    // Zero sends every movement on its own
+    struct MovementInterval : Configuration::ShortEntry {
+        MovementInterval() : ShortEntry("MovementInterval", "100") {
+        }
+    };
+
+    // The maximum number of effects with the same z value on a character or mob
+    struct EffectLimit : Configuration::ShortEntry {
+        EffectLimit() : ShortEntry("EffectLimit", "64") {
+        }
+    };
+
+    // The maximum number of bullets in flight
+    // A bullet above the limit is not shown and hits right away
+    struct BulletLimit : Configuration::ShortEntry {
+        BulletLimit() : ShortEntry("BulletLimit", "256") {
+        }
+    };
+
+    // The maximum number of damage numbers shown at once
+    struct DamageNumberLimit : Configuration::ShortEntry {
+        DamageNumberLimit() : ShortEntry("DamageNumberLimit", "512") {
+        }
+    };
+
+    // Write all packets to this file, see 'PacketRecorder'
+    // Empty disables capturing
+    struct PacketCapture : Configuration::StringEntry {
+        PacketCapture() : StringEntry("PacketCapture", "") {
+        }
+    };
+
+    // Whether to move mobs and drops in one physics batch per tick
+    struct BatchedPhysics : Configuration::BoolEntry {
+        BatchedPhysics() : BoolEntry("BatchedPhysics", "true") {
+        }
+    };
+
+    // Whether to record the time spent in each part of the game loop, see 'Profiler'
+    struct Profiling : Configuration::BoolEntry {
+        Profiling() : BoolEntry("Profiling", "false") {
+        }
+    };
+
+    // The map loaded by the headless simulation
+    struct SimulationMap : Configuration::IntEntry {
+        SimulationMap() : IntEntry("SimulationMap", "100000000") {
+        }
+    };
+
+    // The mob spawned by the headless simulation
+    struct SimulationMob : Configuration::IntEntry {
+        SimulationMob() : IntEntry("SimulationMob", "100100") {
+        }
+    };
+
+    // The number of mobs spawned by the headless simulation
+    struct SimulationMobs : Configuration::ShortEntry {
+        SimulationMobs() : ShortEntry("SimulationMobs", "200") {
+        }
+    };
+
+    // A packet capture replayed by the headless simulation instead of its script
+    // Empty uses the script
+    struct SimulationCapture : Configuration::StringEntry {
+        SimulationCapture() : StringEntry("SimulationCapture", "") {
+        }
+    };
+
+    // How many times faster than recorded the headless simulation replays the capture
+    struct SimulationSpeed : Configuration::ShortEntry {
+        SimulationSpeed() : ShortEntry("SimulationSpeed", "1") {
+        }
+    };
+
+    // The number of fixed timesteps run by the headless simulation
+    struct SimulationTicks : Configuration::IntEntry {
+        SimulationTicks() : IntEntry("SimulationTicks", "6000") {
+        }
+    };
+
     // Music Volume
     // Number from 0 to 100
     struct BGMVolume : Configuration::ByteEntry {
@@ -371,6 +498,19 @@ namespace ms {
         }
     };
 
+    // The number of messages kept by UIChatBar
+    struct ChatLogSize : Configuration::ShortEntry {
+        ChatLogSize() : ShortEntry("ChatLogSize", "500") {
+        }
+    };
+
+    // Append all chat messages to this file
+    // Empty disables the transcript
+    struct ChatTranscript : Configuration::StringEntry {
+        ChatTranscript() : StringEntry("ChatTranscript", "") {
+        }
+    };
+
     // The default position of UIStatsInfo
     struct PosSTATS : Configuration::PointEntry {
         PosSTATS() : PointEntry("PosSTATS", "(72,72)") {
@@ -17,6 +17,8 @@
 //////////////////////////////////////////////////////////////////////////////////
 #include "Combat.h"
 
+#include "../../Configuration.h"
+
 #include "../../Character/SkillId.h"
 #include "../../IO/Messages.h"
 
@@ -37,6 +39,11 @@ namespace ms {
         }) {
     }
 
+    void Combat::init() {
+        bullets.set_capacity(Setting<BulletLimit>::get().load());
+        damagenumbers.set_capacity(Setting<DamageNumberLimit>::get().load());
+    }
+
     void Combat::draw(double viewx, double viewy, float alpha) const {
         for (auto& be : bullets)
             be.bullet.draw(viewx, viewy, alpha);
@@ -157,39 +164,18 @@ namespace ms {
 
     std::vector<int32_t> Combat::find_closest(MapObjects* objs, Rectangle<int16_t> range, Point<int16_t> origin,
                                               uint8_t objcount, bool use_mobs) const {
-        std::multimap<uint16_t, int32_t> distances;
-
-        for (auto& mmo : *objs) {
+        return objs->find_closest(range, origin, objcount, [&](const MapObject& mmo) {
             if (use_mobs) {
-                auto mob = static_cast<const Mob*>(mmo.second.get());
+                auto& mob = static_cast<const Mob&>(mmo);
 
-                if (mob && mob->is_alive() && mob->is_in_range(range)) {
-                    int32_t oid = mob->get_object_id();
-                    uint16_t distance = mob->get_position().distance(origin);
-                    distances.emplace(distance, oid);
-                }
+                return mob.is_alive() && mob.is_in_range(range);
             } else {
                 // Assume Reactor
-                auto reactor = static_cast<const Reactor*>(mmo.second.get());
+                auto& reactor = static_cast<const Reactor&>(mmo);
 
-                if (reactor && reactor->is_hittable() && reactor->is_in_range(range)) {
-                    int32_t oid = reactor->get_object_id();
-                    uint16_t distance = reactor->get_position().distance(origin);
-                    distances.emplace(distance, oid);
-                }
+                return reactor.is_hittable() && reactor.is_in_range(range);
             }
-        }
-
-        std::vector<int32_t> targets;
-
-        for (auto& iter : distances) {
-            if (targets.size() >= objcount)
-                break;
-
-            targets.push_back(iter.second);
-        }
-
-        return targets;
+        });
     }
 
     void Combat::apply_use_movement(const SpecialMove& move) {
@@ -225,23 +211,31 @@ namespace ms {
     }
 
     void Combat::apply_bullet_effect(const BulletEffect& effect) {
-        bullets.push_back(effect);
+        BulletEffect* added = bullets.emplace(effect);
 
-        if (bullets.back().bullet.settarget(effect.target)) {
+        // Without space for the bullet the damage is applied right away
+        if (!added || added->bullet.settarget(effect.target)) {
             apply_damage_effect(effect.damageeffect);
-            bullets.pop_back();
+
+            if (added)
+                bullets.pop_back();
         }
     }
 
     void Combat::apply_damage_effect(const DamageEffect& effect) {
         Point<int16_t> head_position = mobs.get_mob_head_position(effect.target_oid);
-        damagenumbers.push_back(effect.number);
-        damagenumbers.back().set_x(head_position.x());
+
+        if (FloatingNumber* number = damagenumbers.emplace(effect.number))
+            number->set_x(head_position.x());
 
         const SpecialMove& move = get_move(effect.move_id);
         mobs.apply_damage(effect.target_oid, effect.damage, effect.toleft, effect.user, move);
     }
 
+    Combat::DropStats Combat::get_drop_stats() const {
+        return {bullets.get_dropped(), damagenumbers.get_dropped()};
+    }
+
     void Combat::push_attack(const AttackResult& attack) {
         attackresults.push(400, attack);
     }
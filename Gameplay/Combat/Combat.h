@@ -24,6 +24,7 @@
 #include "../MapleMap/MapReactors.h"
 
 #include "../../Character/Player.h"
+#include "../../Template/Pool.h"
 #include "../../Template/TimedQueue.h"
 
 namespace ms {
@@ -31,6 +32,9 @@ namespace ms {
     public:
         Combat(Player& player, MapChars& chars, MapMobs& mobs, MapReactors& reactors);
 
+        // Load the maximum number of bullets and damage numbers
+        void init();
+
         // Draw bullets, damage numbers etc.
         void draw(double viewx, double viewy, float alpha) const;
         // Poll attacks, damage effects, etc.
@@ -46,6 +50,15 @@ namespace ms {
         // Show a buff effect
         void show_player_buff(int32_t skillid);
 
+        // Number of effects which were dropped because their pool was full
+        struct DropStats {
+            size_t bullets;
+            size_t damagenumbers;
+        };
+
+        // Return the number of dropped bullets and damage numbers
+        DropStats get_drop_stats() const;
+
     private:
         struct DamageEffect {
             AttackUser user;
@@ -87,7 +100,7 @@ namespace ms {
         TimedQueue<BulletEffect> bulleteffects;
         TimedQueue<DamageEffect> damageeffects;
 
-        std::list<BulletEffect> bullets;
-        std::list<FloatingNumber> damagenumbers;
+        Pool<BulletEffect> bullets;
+        Pool<FloatingNumber> damagenumbers;
     };
 }
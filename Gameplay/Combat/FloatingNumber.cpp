@@ -26,27 +26,23 @@ namespace ms {
         type = t;
 
         if (damage > 0) {
-            miss = false;
-
             std::string number = std::to_string(damage);
-            first_num = number[0];
-
-            if (number.size() > 1) {
-                rest_num = number.substr(1);
-                multiple = true;
-            } else {
-                rest_num = "";
-                multiple = false;
-            }
+            char first_num = number[0];
+
+            charsets[type][false].append(first_run, first_num, {0, 0});
 
             int16_t total = get_advance(first_num, true);
 
-            for (size_t i = 0; i < rest_num.length(); i++) {
-                char c = rest_num[i];
+            for (size_t i = 1; i < number.length(); i++) {
+                char c = number[i];
+                auto yshift = static_cast<int16_t>(i % 2 ? 2 : -2);
+
+                charsets[type][true].append(rest_run, c, {total, yshift});
+
                 int16_t advance;
 
-                if (i < rest_num.length() - 1) {
-                    char n = rest_num[i + 1];
+                if (i < number.length() - 1) {
+                    char n = number[i + 1];
                     advance = (get_advance(c, false) + get_advance(n, false)) / 2;
                 } else {
                     advance = get_advance(c, false);
@@ -57,8 +53,8 @@ namespace ms {
 
             shift = total / 2;
         } else {
+            charsets[type][true].append(rest_run, 'M', {0, 0});
             shift = charsets[type][true].getw('M') / 2;
-            miss = true;
         }
 
         moving_object.set_x(x);
@@ -75,35 +71,8 @@ namespace ms {
         Point<int16_t> position = absolute - Point<int16_t>(0, shift);
         float interopc = opacity.get(alpha);
 
-        if (miss) {
-            charsets[type][true].draw('M', {position, interopc});
-        } else {
-            charsets[type][false].draw(first_num, {position, interopc});
-
-            if (multiple) {
-                int16_t first_advance = get_advance(first_num, true);
-                position.shift_x(first_advance);
-
-                for (size_t i = 0; i < rest_num.length(); i++) {
-                    char c = rest_num[i];
-                    Point<int16_t> yshift = {0, (i % 2) ? -2 : 2};
-                    charsets[type][true].draw(c, {position + yshift, interopc});
-
-                    int16_t advance;
-
-                    if (i < rest_num.length() - 1) {
-                        char n = rest_num[i + 1];
-                        int16_t c_advance = get_advance(c, false);
-                        int16_t n_advance = get_advance(n, false);
-                        advance = (c_advance + n_advance) / 2;
-                    } else {
-                        advance = get_advance(c, false);
-                    }
-
-                    position.shift_x(advance);
-                }
-            }
-        }
+        charsets[type][false].draw(first_run, {position, interopc});
+        charsets[type][true].draw(rest_run, {position, interopc});
     }
 
     int16_t FloatingNumber::get_advance(char c, bool first) const {
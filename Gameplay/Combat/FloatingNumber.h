@@ -51,10 +51,9 @@ namespace ms {
         static constexpr uint16_t FADE_TIME = 600;
 
         Type type;
-        bool miss;
-        bool multiple;
-        int8_t first_num;
-        std::string rest_num;
+        // The first digit uses a larger charset than the rest of the number, a miss only uses the second
+        Charset::Run first_run;
+        Charset::Run rest_run;
         int16_t shift;
         MovingObject moving_object;
         Linear<float> opacity;
@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "MapLoader.h"
+
+#include "../Util/Misc.h"
+
+#include <algorithm>
+
+#ifdef USE_NX
+#include <nlnx/nx.hpp>
+#endif
+
+namespace ms {
+    void MapLoader::prefetch(int32_t mapid) {
+        for (auto& request : requests)
+            if (request.mapid == mapid)
+                return;
+
+        if (requests.size() >= MAXREQUESTS) {
+            // Only drop requests which are finished, destroying a running future would block
+            auto ready = std::find_if(requests.begin(), requests.end(), [](const Request& request) {
+                return request.bundle.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            });
+
+            if (ready == requests.end())
+                return;
+
+            requests.erase(ready);
+        }
+
+        requests.push_back({mapid, std::async(std::launch::async, &MapLoader::load, mapid)});
+    }
+
+    std::unique_ptr<MapBundle> MapLoader::take(int32_t mapid) {
+        std::unique_ptr<MapBundle> bundle;
+
+        for (auto iter = requests.begin(); iter != requests.end(); ++iter) {
+            if (iter->mapid == mapid) {
+                bundle = iter->bundle.get();
+                requests.erase(iter);
+                break;
+            }
+        }
+
+        // Speculative loads for the previous map are unlikely to be needed anymore
+        clear();
+
+        if (!bundle)
+            bundle = load(mapid);
+
+        return bundle;
+    }
+
+    void MapLoader::clear() {
+        requests.erase(
+            std::remove_if(requests.begin(), requests.end(), [](const Request& request) {
+                return request.bundle.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            }),
+            requests.end()
+        );
+    }
+
+    std::unique_ptr<MapBundle> MapLoader::load(int32_t mapid) {
+        std::string strid = string_format::extend_id(mapid, 9);
+        std::string prefix = std::to_string(mapid / 100000000);
+
+        nl::node src = mapid == -1
+                           ? nl::nx::UI["CashShopPreview.img"]
+                           : nl::nx::Map["Map"]["Map" + prefix][strid + ".img"];
+
+        auto bundle = std::make_unique<MapBundle>();
+        bundle->mapid = mapid;
+        bundle->tilesobjs = MapTilesObjs(src);
+        bundle->backgrounds = MapBackgrounds(src["back"]);
+        bundle->physics = Physics(src["foothold"]);
+        bundle->map_info = MapInfo(src, bundle->physics.get_fht().get_walls(true),
+                                   bundle->physics.get_fht().get_borders());
+        bundle->portals = MapPortals(src["portal"], mapid);
+
+        return bundle;
+    }
+}
@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "MapleMap/MapBackgrounds.h"
+#include "MapleMap/MapInfo.h"
+#include "MapleMap/MapPortals.h"
+#include "MapleMap/MapTilesObjs.h"
+
+#include "Physics/Physics.h"
+
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace ms {
+    // Everything parsed from the NX files which makes up the static part of a map
+    struct MapBundle {
+        int32_t mapid;
+        MapTilesObjs tilesobjs;
+        MapBackgrounds backgrounds;
+        Physics physics;
+        MapInfo map_info;
+        MapPortals portals;
+    };
+
+    // Builds map bundles on worker threads so that changing maps only has to swap them in
+    class MapLoader {
+    public:
+        // Start loading a map in the background, if it is not already loaded or being loaded
+        void prefetch(int32_t mapid);
+        // Return the bundle for a map, waiting for a prefetch or loading it on the calling thread
+        std::unique_ptr<MapBundle> take(int32_t mapid);
+        // Drop all prefetched maps
+        void clear();
+
+    private:
+        static std::unique_ptr<MapBundle> load(int32_t mapid);
+
+        struct Request {
+            int32_t mapid;
+            std::future<std::unique_ptr<MapBundle>> bundle;
+        };
+
+        static constexpr size_t MAXREQUESTS = 4;
+
+        std::vector<Request> requests;
+    };
+}
@@ -51,9 +51,7 @@ namespace ms {
         }
     }
 
-    int8_t Drop::update(const Physics& physics) {
-        physics.move_object(physics_object);
-
+    int8_t Drop::update_after_move(const Physics&) {
         if (state == DROPPED) {
             if (physics_object.is_on_ground) {
                 physics_object.h_speed = 0.0;
@@ -112,7 +110,7 @@ namespace ms {
         }
     }
 
-    Rectangle<int16_t> Drop::bounds() const {
+    Rectangle<int16_t> Drop::get_bounds() const {
         auto lt = get_position();
         auto rb = lt + Point<int16_t>(32, 32);
 
@@ -24,11 +24,11 @@
 namespace ms {
     class Drop : public MapObject {
     public:
-        int8_t update(const Physics& physics) override;
+        int8_t update_after_move(const Physics& physics) override;
 
         void expire(int8_t, const PhysicsObject*);
 
-        Rectangle<int16_t> bounds() const;
+        Rectangle<int16_t> get_bounds() const override;
 
     protected:
         Drop(int32_t oid, int32_t owner, Point<int16_t> start,
@@ -23,6 +23,8 @@
 
 #include "../../Character/OtherChar.h"
 
+#include <queue>
+
 namespace ms {
     // A collection of remote controlled characters on a map
     class MapChars {
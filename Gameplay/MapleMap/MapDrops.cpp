@@ -19,6 +19,7 @@
 
 #include "Drop.h"
 
+#include "../../Configuration.h"
 #include "../../Data/ItemData.h"
 
 #ifdef USE_NX
@@ -76,7 +77,10 @@ namespace ms {
         for (auto& mesoicon : mesoicons)
             mesoicon.update();
 
-        drops.update(physics);
+        if (Setting<BatchedPhysics>::get().load())
+            drops.update_batched(physics);
+        else
+            drops.update(physics);
 
         lootenabled = true;
     }
@@ -98,13 +102,12 @@ namespace ms {
         if (!lootenabled)
             return {0, {}};
 
-        for (auto& mmo : drops) {
-            Optional<const Drop> drop = mmo.second.get();
+        for (int32_t oid : drops.find_in_range(Rectangle<int16_t>(playerpos, playerpos))) {
+            Optional<const Drop> drop = drops.get(oid);
 
-            if (drop && drop->bounds().contains(playerpos)) {
+            if (drop && drop->get_bounds().contains(playerpos)) {
                 lootenabled = false;
 
-                int32_t oid = mmo.first;
                 Point<int16_t> position = drop->get_position();
 
                 return {oid, position};
@@ -18,6 +18,8 @@
 #include "MapMobs.h"
 #include "Mob.h"
 
+#include "../../Configuration.h"
+
 #include <algorithm>
 #include <iostream>
 #include <map>
@@ -43,7 +45,10 @@ namespace ms {
             }
         }
 
-        mobs.update(physics);
+        if (Setting<BatchedPhysics>::get().load())
+            mobs.update_batched(physics);
+        else
+            mobs.update(physics);
     }
 
     void MapMobs::spawn(MobSpawn&& spawn) {
@@ -117,19 +122,14 @@ namespace ms {
             vertical.greater()
         };
 
-        auto iter = std::find_if(
-            mobs.begin(),
-            mobs.end(),
-            [&player_rect](auto& mmo) {
-                Optional<Mob> mob = mmo.second.get();
-                return mob && mob->is_alive() && mob->is_in_range(player_rect);
-            }
-        );
+        for (int32_t oid : mobs.find_in_range(player_rect)) {
+            Optional<const Mob> mob = mobs.get(oid);
 
-        if (iter == mobs.end())
-            return 0;
+            if (mob && mob->is_alive() && mob->is_in_range(player_rect))
+                return oid;
+        }
 
-        return iter->second->get_object_id();
+        return 0;
     }
 
     MobAttack MapMobs::create_attack(int32_t oid) const {
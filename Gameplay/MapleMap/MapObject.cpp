@@ -24,8 +24,17 @@ namespace ms {
     }
 
     int8_t MapObject::update(const Physics& physics) {
-        physics.move_object(physics_object);
+        if (update_before_move(physics))
+            physics.move_object(physics_object);
 
+        return update_after_move(physics);
+    }
+
+    bool MapObject::update_before_move(const Physics&) {
+        return true;
+    }
+
+    int8_t MapObject::update_after_move(const Physics&) {
         return physics_object.fh_layer;
     }
 
@@ -56,6 +65,12 @@ namespace ms {
         return physics_object.fh_layer;
     }
 
+    Rectangle<int16_t> MapObject::get_bounds() const {
+        Point<int16_t> position = get_position();
+
+        return Rectangle<int16_t>(position, position);
+    }
+
     int32_t MapObject::get_object_id() const {
         return object_id;
     }
@@ -63,4 +78,8 @@ namespace ms {
     Point<int16_t> MapObject::get_position() const {
         return physics_object.get_position();
     }
+
+    PhysicsObject& MapObject::get_physics_object() {
+        return physics_object;
+    }
 }
@@ -21,6 +21,8 @@
 
 #include "../Physics/Physics.h"
 
+#include "../../Template/Rectangle.h"
+
 namespace ms {
     // Base for objects on a map, e.g., Mobs, NPCs, Characters, etc.
     class MapObject {
@@ -33,6 +35,11 @@ namespace ms {
 
         // Updates the object and returns the updated layer.
         virtual int8_t update(const Physics& physics);
+        // Runs the part of the update that comes before movement.
+        // Returns false if the object should not be moved this tick.
+        virtual bool update_before_move(const Physics& physics);
+        // Runs the part of the update that comes after movement and returns the updated layer.
+        virtual int8_t update_after_move(const Physics& physics);
         // Reactivates the object.
         virtual void activate();
         // Deactivates the object.
@@ -41,6 +48,8 @@ namespace ms {
         virtual bool is_active() const;
         // Obtains the layer used to determine the drawing order on the map.
         virtual int8_t get_layer() const;
+        // Obtains the area covered by the object, used to find objects by position.
+        virtual Rectangle<int16_t> get_bounds() const;
 
         // Changes the objects position.
         void set_position(int16_t x, int16_t y);
@@ -51,6 +60,8 @@ namespace ms {
         int32_t get_object_id() const;
         // Returns the current position.
         Point<int16_t> get_position() const;
+        // Returns the physics object used for movement.
+        PhysicsObject& get_physics_object();
 
     protected:
         MapObject(int32_t oid, Point<int16_t> position = {});
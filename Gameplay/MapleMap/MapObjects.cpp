@@ -17,47 +17,108 @@
 //////////////////////////////////////////////////////////////////////////////////
 #include "MapObjects.h"
 
+#include "../../Constants.h"
+
 namespace ms {
     void MapObjects::draw(Layer::Id layer, double viewx, double viewy, float alpha) const {
-        for (auto& oid : layers[layer]) {
-            auto mmo = get(oid);
+        auto view = Point<int16_t>(static_cast<int16_t>(viewx), static_cast<int16_t>(viewy));
+
+        if (!visiblevalid || view != visibleview)
+            collect_visible(view);
 
-            if (mmo && mmo->is_active())
+        for (const MapObject* mmo : visible[layer])
+            if (mmo->is_active())
                 mmo->draw(viewx, viewy, alpha);
+    }
+
+    void MapObjects::collect_visible(Point<int16_t> view) const {
+        int16_t width = Constants::Constants::get().get_view_width();
+        int16_t height = Constants::Constants::get().get_view_height();
+
+        Rectangle<int16_t> area(
+            -view.x() - DRAWMARGIN,
+            -view.x() + width + DRAWMARGIN,
+            -view.y() - DRAWMARGIN,
+            -view.y() + height + DRAWMARGIN
+        );
+
+        grid.query(area, found);
+
+        for (auto& layer : visible)
+            layer.clear();
+
+        for (int32_t oid : found) {
+            auto iter = objects.find(oid);
+
+            if (iter != objects.end() && iter->second)
+                visible[iter->second->get_layer()].push_back(iter->second.get());
         }
+
+        visibleview = view;
+        visiblevalid = true;
     }
 
     void MapObjects::update(const Physics& physics) {
+        visiblevalid = false;
+
         for (auto iter = objects.begin(); iter != objects.end();) {
             bool remove_mob = false;
 
             if (auto& mmo = iter->second) {
-                int8_t oldlayer = mmo->get_layer();
-                int8_t newlayer = mmo->update(physics);
+                if (mmo->update(physics) == -1)
+                    remove_mob = true;
+                else
+                    grid.update(iter->first, mmo->get_bounds());
+            } else {
+                remove_mob = true;
+            }
+
+            if (remove_mob) {
+                grid.remove(iter->first);
+                iter = objects.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+    void MapObjects::update_batched(const Physics& physics) {
+        visiblevalid = false;
+        batch.clear();
+
+        for (auto& iter : objects)
+            if (auto& mmo = iter.second)
+                if (mmo->update_before_move(physics))
+                    batch.add(mmo->get_physics_object());
 
-                if (newlayer == -1) {
+        physics.move_objects(batch);
+
+        for (auto iter = objects.begin(); iter != objects.end();) {
+            bool remove_mob = false;
+
+            if (auto& mmo = iter->second) {
+                if (mmo->update_after_move(physics) == -1)
                     remove_mob = true;
-                } else if (newlayer != oldlayer) {
-                    int32_t oid = iter->first;
-                    layers[oldlayer].erase(oid);
-                    layers[newlayer].insert(oid);
-                }
+                else
+                    grid.update(iter->first, mmo->get_bounds());
             } else {
                 remove_mob = true;
             }
 
-            if (remove_mob)
+            if (remove_mob) {
+                grid.remove(iter->first);
                 iter = objects.erase(iter);
-            else
+            } else {
                 ++iter;
+            }
         }
     }
 
     void MapObjects::clear() {
         objects.clear();
+        grid.clear();
 
-        for (auto& layer : layers)
-            layer.clear();
+        visiblevalid = false;
     }
 
     bool MapObjects::contains(int32_t oid) const {
@@ -66,19 +127,20 @@ namespace ms {
 
     void MapObjects::add(std::unique_ptr<MapObject> toadd) {
         int32_t oid = toadd->get_object_id();
-        int8_t layer = toadd->get_layer();
+        grid.update(oid, toadd->get_bounds());
         objects[oid] = std::move(toadd);
-        layers[layer].insert(oid);
+
+        visiblevalid = false;
     }
 
     void MapObjects::remove(int32_t oid) {
         auto iter = objects.find(oid);
 
         if (iter != objects.end() && iter->second) {
-            int8_t layer = iter->second->get_layer();
             objects.erase(iter);
+            grid.remove(oid);
 
-            layers[layer].erase(oid);
+            visiblevalid = false;
         }
     }
 
@@ -94,6 +156,21 @@ namespace ms {
         return iter != objects.end() ? iter->second.get() : nullptr;
     }
 
+    std::vector<int32_t> MapObjects::find_in_range(const Rectangle<int16_t>& range) const {
+        std::vector<int32_t> result;
+        grid.query(range, result);
+
+        auto outside = [&](int32_t oid) {
+            auto iter = objects.find(oid);
+
+            return iter == objects.end() || !iter->second || !range.overlaps(iter->second->get_bounds());
+        };
+
+        result.erase(std::remove_if(result.begin(), result.end(), outside), result.end());
+
+        return result;
+    }
+
     MapObjects::underlying_t::iterator MapObjects::begin() {
         return objects.begin();
     }
@@ -19,11 +19,12 @@
 
 #include "Layer.h"
 #include "MapObject.h"
+#include "SpatialGrid.h"
 
 #include "../../Template/Optional.h"
 
+#include <algorithm>
 #include <memory>
-#include <unordered_set>
 
 namespace ms {
     // A collection of generic MapObjects
@@ -34,6 +35,8 @@ namespace ms {
         // Update all MapObjects of this type
         // Also updates layers (E.g. drawing order)
         void update(const Physics& physics);
+        // Update all MapObjects of this type, moving them together in one physics batch
+        void update_batched(const Physics& physics);
 
         // Adds a MapObjects of this type
         void add(std::unique_ptr<MapObject> mapobject);
@@ -49,6 +52,14 @@ namespace ms {
         // Obtains a constant pointer to the MapObject with the given object_id
         Optional<const MapObject> get(int32_t oid) const;
 
+        // Obtains the ids of all MapObjects whose bounds overlap the range, in ascending order
+        std::vector<int32_t> find_in_range(const Rectangle<int16_t>& range) const;
+        // Obtains the ids of up to 'count' MapObjects whose bounds overlap the range and which satisfy the predicate
+        // The ids are sorted by the distance of the objects to the origin
+        template <typename Predicate>
+        std::vector<int32_t> find_closest(const Rectangle<int16_t>& range, Point<int16_t> origin, size_t count,
+                                          Predicate predicate) const;
+
         using underlying_t = std::unordered_map<int32_t, std::unique_ptr<MapObject>>;
         // Return a begin iterator
         underlying_t::iterator begin();
@@ -62,7 +73,47 @@ namespace ms {
         underlying_t::size_type size() const;
 
     private:
+        // Sort the objects near the view into their layers
+        void collect_visible(Point<int16_t> view) const;
+
+        // Objects further than this outside the view are not drawn
+        static constexpr int16_t DRAWMARGIN = 400;
+
         std::unordered_map<int32_t, std::unique_ptr<MapObject>> objects;
-        std::array<std::unordered_set<int32_t>, Layer::Id::LENGTH> layers;
+        SpatialGrid grid;
+        PhysicsBatch batch;
+
+        mutable std::vector<int32_t> found;
+        mutable std::array<std::vector<const MapObject*>, Layer::Id::LENGTH> visible;
+        mutable Point<int16_t> visibleview;
+        mutable bool visiblevalid = false;
     };
+
+    template <typename Predicate>
+    std::vector<int32_t> MapObjects::find_closest(const Rectangle<int16_t>& range, Point<int16_t> origin, size_t count,
+                                                  Predicate predicate) const {
+        std::vector<std::pair<uint16_t, int32_t>> distances;
+
+        for (int32_t oid : find_in_range(range)) {
+            const MapObject& mmo = *objects.at(oid);
+
+            if (predicate(mmo))
+                distances.emplace_back(mmo.get_position().distance(origin), oid);
+        }
+
+        std::stable_sort(distances.begin(), distances.end(), [](auto& a, auto& b) {
+            return a.first < b.first;
+        });
+
+        std::vector<int32_t> targets;
+
+        for (auto& iter : distances) {
+            if (targets.size() >= count)
+                break;
+
+            targets.push_back(iter.second);
+        }
+
+        return targets;
+    }
 }
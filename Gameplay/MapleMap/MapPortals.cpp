@@ -39,7 +39,8 @@ namespace ms {
             int32_t target_id = sub["tm"];
             Point<int16_t> position = {sub["x"], sub["y"]};
 
-            const Animation* animation = &animations[type];
+            auto aniter = animations.find(type);
+            const Animation* animation = aniter != animations.end() ? &aniter->second : nullptr;
             bool intramap = target_id == mapid;
 
             portals_by_id.emplace(
@@ -100,6 +101,22 @@ namespace ms {
         return {};
     }
 
+    std::vector<int32_t> MapPortals::get_destinations_near(Point<int16_t> position, int16_t range) const {
+        std::vector<int32_t> destinations;
+
+        for (auto& iter : portals_by_id) {
+            Portal::WarpInfo warpinfo = iter.second.getwarpinfo();
+
+            if (!warpinfo.valid || warpinfo.intramap)
+                continue;
+
+            if (iter.second.get_position().distance(position) <= range)
+                destinations.push_back(warpinfo.mapid);
+        }
+
+        return destinations;
+    }
+
     Portal::WarpInfo MapPortals::find_warp_at(Point<int16_t> playerpos) {
         if (cooldown == 0) {
             cooldown = WARPCD;
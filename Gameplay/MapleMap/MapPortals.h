@@ -20,6 +20,7 @@
 #include "Portal.h"
 
 #include <unordered_map>
+#include <vector>
 
 namespace ms {
     // Collection of portals on a map
@@ -39,6 +40,8 @@ namespace ms {
 
         Point<int16_t> get_portal_by_id(uint8_t id) const;
         Point<int16_t> get_portal_by_name(const std::string& name) const;
+        // Return the maps which portals within range of the position lead to
+        std::vector<int32_t> get_destinations_near(Point<int16_t> position, int16_t range) const;
 
     private:
         static std::unordered_map<Portal::Type, Animation> animations;
@@ -17,8 +17,10 @@
 //////////////////////////////////////////////////////////////////////////////////
 #include "MapTilesObjs.h"
 
+#include "../../Graphics/GraphicsGL.h"
+
 namespace ms {
-    TilesObjs::TilesObjs(nl::node src) {
+    TilesObjs::TilesObjs(nl::node src) : batch(0) {
         auto tileset = src["info"]["tS"] + ".img";
 
         for (auto tilenode : src["tile"]) {
@@ -43,8 +45,23 @@ namespace ms {
         for (auto& iter : objs)
             iter.second.draw(viewpos, alpha);
 
+        GraphicsGL& graphics = GraphicsGL::get();
+
+        if (graphics.drawbatch(batch, viewpos))
+            return;
+
+        if (!graphics.beginbatch()) {
+            for (auto& iter : tiles)
+                iter.second.draw(viewpos);
+
+            return;
+        }
+
         for (auto& iter : tiles)
-            iter.second.draw(viewpos);
+            iter.second.draw(Point<int16_t>());
+
+        batch = graphics.endbatch();
+        graphics.drawbatch(batch, viewpos);
     }
 
     MapTilesObjs::MapTilesObjs(nl::node src) {
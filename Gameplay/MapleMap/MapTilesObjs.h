@@ -29,7 +29,7 @@ namespace ms {
     // A tile and object layer
     class TilesObjs {
     public:
-        TilesObjs() {
+        TilesObjs() : batch(0) {
         }
 
         TilesObjs(nl::node src);
@@ -40,6 +40,9 @@ namespace ms {
     private:
         std::multimap<uint8_t, Tile> tiles;
         std::multimap<uint8_t, Obj> objs;
+
+        // The tiles never change, so they are recorded once into a batch of the graphics engine
+        mutable size_t batch;
     };
 
     // The collection of tile and object layers on a map
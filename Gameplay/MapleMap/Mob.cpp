@@ -102,6 +102,7 @@ namespace ms {
         set_stance(st);
         flydirection = STRAIGHT;
         counter = 0;
+        aniend = false;
 
         namelabel = Text(Text::Font::A13M, Text::Alignment::CENTER, Color::Name::WHITE, Text::Background::NAMETAG,
                          name);
@@ -138,11 +139,11 @@ namespace ms {
         }
     }
 
-    int8_t Mob::update(const Physics& physics) {
+    bool Mob::update_before_move(const Physics&) {
         if (!active)
-            return physics_object.fh_layer;
+            return false;
 
-        bool aniend = animations.at(stance).update();
+        aniend = animations.at(stance).update();
 
         if (aniend && stance == DIE)
             dead = true;
@@ -164,58 +165,69 @@ namespace ms {
             }
         }
 
-        if (dead) {
-            deactivate();
-
-            return -1;
-        }
+        if (dead)
+            return false;
 
         effects.update();
         showhp.update();
 
-        if (!dying) {
-            if (!canfly) {
-                if (physics_object.is_flag_not_set(PhysicsObject::Flag::TURN_AT_EDGES)) {
-                    flip = !flip;
-                    physics_object.set_flag(PhysicsObject::Flag::TURN_AT_EDGES);
+        if (dying)
+            return false;
 
-                    if (stance == HIT)
-                        set_stance(STAND);
-                }
-            }
+        if (!canfly) {
+            if (physics_object.is_flag_not_set(PhysicsObject::Flag::TURN_AT_EDGES)) {
+                flip = !flip;
+                physics_object.set_flag(PhysicsObject::Flag::TURN_AT_EDGES);
 
-            switch (stance) {
-            case MOVE:
-                if (canfly) {
-                    physics_object.h_force = flip ? flyspeed : -flyspeed;
+                if (stance == HIT)
+                    set_stance(STAND);
+            }
+        }
 
-                    switch (flydirection) {
-                    case UPWARDS:
-                        physics_object.v_force = -flyspeed;
-                        break;
-                    case DOWNWARDS:
-                        physics_object.v_force = flyspeed;
-                        break;
-                    }
-                } else {
-                    physics_object.h_force = flip ? speed : -speed;
-                }
+        switch (stance) {
+        case MOVE:
+            if (canfly) {
+                physics_object.h_force = flip ? flyspeed : -flyspeed;
 
-                break;
-            case HIT:
-                if (canmove) {
-                    double KBFORCE = physics_object.is_on_ground ? 0.2 : 0.1;
-                    physics_object.h_force = flip ? -KBFORCE : KBFORCE;
+                switch (flydirection) {
+                case UPWARDS:
+                    physics_object.v_force = -flyspeed;
+                    break;
+                case DOWNWARDS:
+                    physics_object.v_force = flyspeed;
+                    break;
                 }
+            } else {
+                physics_object.h_force = flip ? speed : -speed;
+            }
 
-                break;
-            case JUMP:
-                physics_object.v_force = -5.0;
-                break;
+            break;
+        case HIT:
+            if (canmove) {
+                double KBFORCE = physics_object.is_on_ground ? 0.2 : 0.1;
+                physics_object.h_force = flip ? -KBFORCE : KBFORCE;
             }
 
-            physics.move_object(physics_object);
+            break;
+        case JUMP:
+            physics_object.v_force = -5.0;
+            break;
+        }
+
+        return true;
+    }
 
+    int8_t Mob::update_after_move(const Physics& physics) {
+        if (!active)
+            return physics_object.fh_layer;
+
+        if (dead) {
+            deactivate();
+
+            return -1;
+        }
+
+        if (!dying) {
             if (control) {
                 counter++;
 
@@ -534,14 +546,18 @@ namespace ms {
         return active && !dying;
     }
 
+    Rectangle<int16_t> Mob::get_bounds() const {
+        Rectangle<int16_t> bounds = animations.at(stance).get_bounds();
+        bounds.shift(get_position());
+
+        return bounds;
+    }
+
     bool Mob::is_in_range(const Rectangle<int16_t>& range) const {
         if (!active)
             return false;
 
-        Rectangle<int16_t> bounds = animations.at(stance).get_bounds();
-        bounds.shift(get_position());
-
-        return range.overlaps(bounds);
+        return range.overlaps(get_bounds());
     }
 
     Point<int16_t> Mob::get_head_position() const {
@@ -69,8 +69,12 @@ namespace ms {
 
         // Draw the mob
         void draw(double viewx, double viewy, float alpha) const override;
-        // Update movement and animations
-        int8_t update(const Physics& physics) override;
+        // Update animations and apply movement forces
+        bool update_before_move(const Physics& physics) override;
+        // Update the mob's ai after it has moved
+        int8_t update_after_move(const Physics& physics) override;
+        // Return the area covered by the current animation frame
+        Rectangle<int16_t> get_bounds() const override;
 
         // Change this mob's control mode:
         // 0 - no control, 1 - control, 2 - aggro
@@ -163,6 +167,7 @@ namespace ms {
 
         std::vector<Movement> movements;
         uint16_t counter;
+        bool aniend;
 
         int32_t id;
         int8_t effect;
@@ -84,15 +84,19 @@ namespace ms {
         return hittable;
     }
 
-    bool Reactor::is_in_range(const Rectangle<int16_t>& range) const {
-        if (!active)
-            return false;
-
+    Rectangle<int16_t> Reactor::get_bounds() const {
         Rectangle<int16_t> bounds(Point<int16_t>(-30, -normal.get_dimensions().y()),
                                   Point<int16_t>(normal.get_dimensions().x() - 10, 0));
         //normal.get_bounds(); //animations.at(stance).get_bounds();
         bounds.shift(get_position());
 
-        return range.overlaps(bounds);
+        return bounds;
+    }
+
+    bool Reactor::is_in_range(const Rectangle<int16_t>& range) const {
+        if (!active)
+            return false;
+
+        return range.overlaps(get_bounds());
     }
 }
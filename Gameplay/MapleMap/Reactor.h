@@ -30,6 +30,7 @@ namespace ms {
 
         void draw(double viewx, double viewy, float alpha) const override;
         int8_t update(const Physics& physics) override;
+        Rectangle<int16_t> get_bounds() const override;
 
         void set_state(int8_t state);
         void destroy(int8_t state, Point<int16_t> position);
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "SpatialGrid.h"
+
+#include <algorithm>
+
+namespace ms {
+    void SpatialGrid::update(int32_t oid, const Rectangle<int16_t>& area) {
+        Cells cells = cells_of(area);
+        auto iter = entries.find(oid);
+
+        if (iter != entries.end()) {
+            if (iter->second == cells)
+                return;
+
+            erase(oid, iter->second);
+            iter->second = cells;
+        } else {
+            entries.emplace(oid, cells);
+        }
+
+        insert(oid, cells);
+    }
+
+    void SpatialGrid::remove(int32_t oid) {
+        auto iter = entries.find(oid);
+
+        if (iter == entries.end())
+            return;
+
+        erase(oid, iter->second);
+        entries.erase(iter);
+    }
+
+    void SpatialGrid::clear() {
+        grid.clear();
+        entries.clear();
+    }
+
+    void SpatialGrid::query(const Rectangle<int16_t>& area, std::vector<int32_t>& result) const {
+        result.clear();
+
+        Cells cells = cells_of(area);
+
+        // Very large areas are cheaper to answer by visiting the occupied cells
+        if (cells.count() > grid.size()) {
+            for (auto& iter : grid) {
+                int16_t x = static_cast<int16_t>(iter.first >> 16);
+                int16_t y = static_cast<int16_t>(iter.first & 0xFFFF);
+
+                if (x >= cells.left && x <= cells.right && y >= cells.top && y <= cells.bottom)
+                    result.insert(result.end(), iter.second.begin(), iter.second.end());
+            }
+        } else {
+            for (int16_t x = cells.left; x <= cells.right; x++) {
+                for (int16_t y = cells.top; y <= cells.bottom; y++) {
+                    auto iter = grid.find(key(x, y));
+
+                    if (iter != grid.end())
+                        result.insert(result.end(), iter->second.begin(), iter->second.end());
+                }
+            }
+        }
+
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+
+    SpatialGrid::Cells SpatialGrid::cells_of(const Rectangle<int16_t>& area) {
+        int16_t left = std::min(area.left(), area.right());
+        int16_t right = std::max(area.left(), area.right());
+        int16_t top = std::min(area.top(), area.bottom());
+        int16_t bottom = std::max(area.top(), area.bottom());
+
+        return {
+            static_cast<int16_t>(left >> CELLSHIFT),
+            static_cast<int16_t>(right >> CELLSHIFT),
+            static_cast<int16_t>(top >> CELLSHIFT),
+            static_cast<int16_t>(bottom >> CELLSHIFT)
+        };
+    }
+
+    int32_t SpatialGrid::key(int16_t x, int16_t y) {
+        return static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint16_t>(x)) << 16 | static_cast<uint16_t>(y));
+    }
+
+    void SpatialGrid::insert(int32_t oid, const Cells& cells) {
+        for (int16_t x = cells.left; x <= cells.right; x++)
+            for (int16_t y = cells.top; y <= cells.bottom; y++)
+                grid[key(x, y)].push_back(oid);
+    }
+
+    void SpatialGrid::erase(int32_t oid, const Cells& cells) {
+        for (int16_t x = cells.left; x <= cells.right; x++) {
+            for (int16_t y = cells.top; y <= cells.bottom; y++) {
+                auto iter = grid.find(key(x, y));
+
+                if (iter == grid.end())
+                    continue;
+
+                std::vector<int32_t>& cell = iter->second;
+                auto found = std::find(cell.begin(), cell.end(), oid);
+
+                if (found != cell.end()) {
+                    *found = cell.back();
+                    cell.pop_back();
+                }
+
+                if (cell.empty())
+                    grid.erase(iter);
+            }
+        }
+    }
+}
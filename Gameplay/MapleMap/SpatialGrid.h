@@ -0,0 +1,70 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "../../Template/Rectangle.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ms {
+    // A uniform grid over a map which finds objects by the area they cover
+    // Objects are kept in every cell their area touches
+    class SpatialGrid {
+    public:
+        // Add an object, or move it to the cells touched by its new area
+        void update(int32_t oid, const Rectangle<int16_t>& area);
+        // Remove an object from the grid
+        void remove(int32_t oid);
+        // Remove all objects
+        void clear();
+
+        // Replace the contents of 'result' with the ids of all objects in cells touched by the area
+        // The ids are sorted in ascending order and contain no duplicates
+        void query(const Rectangle<int16_t>& area, std::vector<int32_t>& result) const;
+
+    private:
+        // An inclusive range of cells
+        struct Cells {
+            int16_t left;
+            int16_t right;
+            int16_t top;
+            int16_t bottom;
+
+            bool operator==(const Cells& other) const {
+                return left == other.left && right == other.right && top == other.top && bottom == other.bottom;
+            }
+
+            size_t count() const {
+                return static_cast<size_t>(right - left + 1) * static_cast<size_t>(bottom - top + 1);
+            }
+        };
+
+        static Cells cells_of(const Rectangle<int16_t>& area);
+        static int32_t key(int16_t x, int16_t y);
+
+        void insert(int32_t oid, const Cells& cells);
+        void erase(int32_t oid, const Cells& cells);
+
+        // Cells are 256 by 256 pixels
+        static constexpr int16_t CELLSHIFT = 8;
+
+        std::unordered_map<int32_t, std::vector<int32_t>> grid;
+        std::unordered_map<int32_t, Cells> entries;
+    };
+}
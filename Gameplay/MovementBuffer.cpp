@@ -0,0 +1,147 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "MovementBuffer.h"
+
+#include "../Constants.h"
+
+#include <algorithm>
+
+namespace ms {
+    namespace {
+        double catmull_rom(double p0, double p1, double p2, double p3, double t) {
+            double t2 = t * t;
+            double t3 = t2 * t;
+
+            return 0.5 * (2.0 * p1
+                          + (p2 - p0) * t
+                          + (2.0 * p0 - 5.0 * p1 + 4.0 * p2 - p3) * t2
+                          + (3.0 * p1 - p0 - 3.0 * p2 + p3) * t3);
+        }
+    }
+
+    MovementBuffer::MovementBuffer() {
+        reset({}, 0);
+    }
+
+    void MovementBuffer::reset(Point<int16_t> start, uint8_t startstate) {
+        pending.clear();
+
+        current = {static_cast<double>(start.x()), static_cast<double>(start.y()), startstate, 0};
+        previous = current;
+        position = Point<double>(current.x, current.y);
+        state = startstate;
+
+        elapsed = 0;
+        buffered = 0;
+        waited = 0;
+        playing = false;
+        changed = true;
+    }
+
+    void MovementBuffer::push(const std::vector<Movement>& movements) {
+        Waypoint last = pending.empty() ? current : pending.back();
+
+        for (const Movement& movement : movements) {
+            Waypoint next = last;
+
+            switch (movement.type) {
+            case Movement::ABSOLUTE:
+            case Movement::CHAIR:
+            case Movement::JUMPDOWN:
+                next.x = movement.xpos;
+                next.y = movement.ypos;
+                break;
+            case Movement::RELATIVE:
+                next.x += movement.xpos;
+                next.y += movement.ypos;
+                break;
+            default:
+                // Fragments without a position, such as equip changes
+                continue;
+            }
+
+            // Some clients send durations of zero or one, play them at least for a timestep
+            next.state = movement.newstate;
+            next.duration = static_cast<uint16_t>(std::max<int32_t>(movement.duration, Constants::TIMESTEP));
+
+            pending.push_back(next);
+            buffered += next.duration;
+            last = next;
+        }
+    }
+
+    bool MovementBuffer::update() {
+        bool moved = changed;
+        changed = false;
+
+        if (!playing) {
+            if (pending.empty())
+                return moved;
+
+            waited += Constants::TIMESTEP;
+
+            if (waited < DELAY && buffered < DELAY)
+                return moved;
+
+            playing = true;
+        }
+
+        elapsed += buffered > MAXBUFFERED ? 2 * Constants::TIMESTEP : Constants::TIMESTEP;
+
+        while (!pending.empty() && elapsed >= pending.front().duration) {
+            elapsed -= pending.front().duration;
+            buffered -= pending.front().duration;
+
+            previous = current;
+            current = pending.front();
+            pending.pop_front();
+        }
+
+        Point<double> last = position;
+
+        if (pending.empty()) {
+            // The buffer ran dry, wait at the last waypoint until more fragments arrive
+            position = Point<double>(current.x, current.y);
+            state = current.state;
+
+            elapsed = 0;
+            waited = 0;
+            playing = false;
+        } else {
+            const Waypoint& target = pending.front();
+            const Waypoint& after = pending.size() > 1 ? pending[1] : target;
+            double t = static_cast<double>(elapsed) / target.duration;
+
+            position = Point<double>(
+                catmull_rom(previous.x, current.x, target.x, after.x, t),
+                catmull_rom(previous.y, current.y, target.y, after.y, t)
+            );
+            state = target.state;
+        }
+
+        return moved || position != last;
+    }
+
+    Point<double> MovementBuffer::get_position() const {
+        return position;
+    }
+
+    uint8_t MovementBuffer::get_state() const {
+        return state;
+    }
+}
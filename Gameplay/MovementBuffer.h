@@ -0,0 +1,71 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Movement.h"
+
+#include <deque>
+#include <vector>
+
+namespace ms {
+    // Plays back the movement fragments of a remote object over their durations
+    // Playback starts after a short delay to absorb network jitter and follows a Catmull-Rom spline through the fragments
+    class MovementBuffer {
+    public:
+        MovementBuffer();
+
+        // Discard all fragments and stand at the specified position
+        void reset(Point<int16_t> position, uint8_t state);
+        // Add fragments received from the server
+        void push(const std::vector<Movement>& movements);
+        // Advance playback by one timestep and return whether the position changed
+        bool update();
+
+        // Return the position along the path
+        Point<double> get_position() const;
+        // Return the state of the fragment which is currently played
+        uint8_t get_state() const;
+
+    private:
+        struct Waypoint {
+            double x;
+            double y;
+            uint8_t state;
+            uint16_t duration;
+        };
+
+        // Buffered milliseconds before playback starts
+        static constexpr int32_t DELAY = 200;
+        // Buffered milliseconds above which playback runs at double speed to catch up
+        static constexpr int32_t MAXBUFFERED = 1000;
+
+        // The waypoints which have not been reached yet
+        std::deque<Waypoint> pending;
+        // The last two waypoints which were reached, used as control points of the spline
+        Waypoint previous;
+        Waypoint current;
+
+        Point<double> position;
+        uint8_t state;
+        int32_t elapsed;
+        int32_t buffered;
+        int32_t waited;
+        bool playing;
+        bool changed;
+    };
+}
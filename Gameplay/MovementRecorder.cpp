@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "MovementRecorder.h"
+
+#include "../Constants.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ms {
+    MovementRecorder::MovementRecorder() {
+        interval = 0;
+        sincefragment = 0;
+        sincesent = 0;
+        laststance = 0;
+        stancechanged = false;
+    }
+
+    void MovementRecorder::set_interval(uint16_t value) {
+        interval = value;
+    }
+
+    void MovementRecorder::record(const Movement& movement) {
+        uint16_t maxduration = std::numeric_limits<int16_t>::max();
+
+        Movement fragment = movement;
+        fragment.duration = path.empty() ? Constants::TIMESTEP : std::min(sincefragment, maxduration);
+
+        if (fragment.newstate != laststance)
+            stancechanged = true;
+
+        path.push_back(fragment);
+        laststance = fragment.newstate;
+        sincefragment = 0;
+    }
+
+    bool MovementRecorder::update() {
+        if (sincefragment < std::numeric_limits<uint16_t>::max() - Constants::TIMESTEP)
+            sincefragment += Constants::TIMESTEP;
+
+        if (path.empty())
+            return false;
+
+        sincesent += Constants::TIMESTEP;
+
+        return stancechanged || sincesent >= interval || path.size() >= MAXFRAGMENTS;
+    }
+
+    const std::vector<Movement>& MovementRecorder::get_path() const {
+        return path;
+    }
+
+    void MovementRecorder::clear() {
+        path.clear();
+        sincesent = 0;
+        stancechanged = false;
+    }
+}
@@ -0,0 +1,54 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Movement.h"
+
+#include <vector>
+
+namespace ms {
+    // Collects the movements of an object into a path, so that several fragments are sent in one packet
+    // The path is sent when the interval has passed, when the stance changes or when it is full
+    class MovementRecorder {
+    public:
+        MovementRecorder();
+
+        // Set the milliseconds for which fragments are collected, zero sends every fragment on its own
+        void set_interval(uint16_t interval);
+
+        // Add a fragment to the path, its duration is the time since the previous fragment
+        void record(const Movement& movement);
+        // Advance by one timestep and return whether the path should be sent now
+        bool update();
+        // Return the fragments collected since the last 'clear()'
+        const std::vector<Movement>& get_path() const;
+        // Remove all fragments after the path was sent or became invalid
+        void clear();
+
+    private:
+        // The number of fragments is sent as a byte, but paths are kept well below that
+        static constexpr size_t MAXFRAGMENTS = 64;
+
+        std::vector<Movement> path;
+        uint16_t interval;
+        uint16_t sincefragment;
+        uint16_t sincesent;
+        uint8_t laststance;
+        bool stancechanged;
+    };
+}
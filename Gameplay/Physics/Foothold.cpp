@@ -27,6 +27,10 @@ namespace ms {
                                                                 m_vertical(src["y1"], src["y2"]) {
     }
 
+    Foothold::Foothold(uint16_t id, uint16_t prev, uint16_t next, uint8_t ly, Range<int16_t> horizontal, Range<int16_t> vertical) :
+        m_id(id), m_prev(prev), m_next(next), m_layer(ly), m_horizontal(horizontal), m_vertical(vertical) {
+    }
+
     uint16_t Foothold::id() const {
         return m_id;
     }
@@ -33,6 +33,7 @@ namespace ms {
     public:
         Foothold();
         Foothold(nl::node src, uint16_t id, uint8_t layer);
+        Foothold(uint16_t id, uint16_t prev, uint16_t next, uint8_t layer, Range<int16_t> horizontal, Range<int16_t> vertical);
 
         // Returns the foothold id aka the identifier in game data of this platform
         uint16_t id() const;
@@ -24,13 +24,9 @@ namespace ms {
     constexpr int16_t R_OFFSET = -30;
     constexpr int16_t T_OFFSET = -300;
     constexpr int16_t B_OFFSET = 100;
+    constexpr int16_t COLUMNWIDTH = 64;
 
-    FootholdTree::FootholdTree(nl::node src) {
-        int16_t leftw = 30000;
-        int16_t rightw = -30000;
-        int16_t botb = -30000;
-        int16_t topb = 30000;
-
+    FootholdTree::FootholdTree(nl::node src) : column_origin(0) {
         for (auto basef : src) {
             uint8_t layer;
 
@@ -52,41 +48,115 @@ namespace ms {
                         continue;
                     }
 
-                    const Foothold& foothold = footholds.emplace(
-                        std::piecewise_construct,
-                        std::forward_as_tuple(id),
-                        std::forward_as_tuple(lastf, id, layer)
-                    ).first->second;
+                    add(Foothold(lastf, id, layer));
+                }
+            }
+        }
 
-                    if (foothold.l() < leftw)
-                        leftw = foothold.l();
+        build_bounds();
+        build_columns();
+    }
 
-                    if (foothold.r() > rightw)
-                        rightw = foothold.r();
+    FootholdTree::FootholdTree(const std::vector<Foothold>& source) : column_origin(0) {
+        for (const Foothold& foothold : source)
+            add(foothold);
 
-                    if (foothold.b() > botb)
-                        botb = foothold.b();
+        build_bounds();
+        build_columns();
+    }
 
-                    if (foothold.t() < topb)
-                        topb = foothold.t();
+    FootholdTree::FootholdTree() : column_origin(0) {
+    }
 
-                    if (foothold.is_wall())
-                        continue;
+    void FootholdTree::add(const Foothold& foothold) {
+        uint16_t id = foothold.id();
 
-                    int16_t start = foothold.l();
-                    int16_t end = foothold.r();
+        if (id >= footholds.size())
+            footholds.resize(id + 1);
 
-                    for (int16_t i = start; i <= end; i++)
-                        footholdsbyx.emplace(i, id);
-                }
-            }
+        if (footholds[id].id() == 0)
+            footholds[id] = foothold;
+    }
+
+    void FootholdTree::build_bounds() {
+        int16_t leftw = 30000;
+        int16_t rightw = -30000;
+        int16_t botb = -30000;
+        int16_t topb = 30000;
+
+        for (const Foothold& foothold : footholds) {
+            if (foothold.id() == 0)
+                continue;
+
+            if (foothold.l() < leftw)
+                leftw = foothold.l();
+
+            if (foothold.r() > rightw)
+                rightw = foothold.r();
+
+            if (foothold.b() > botb)
+                botb = foothold.b();
+
+            if (foothold.t() < topb)
+                topb = foothold.t();
         }
 
         walls = {leftw + L_OFFSET, rightw + R_OFFSET};
         borders = {topb + T_OFFSET, botb + B_OFFSET};
     }
 
-    FootholdTree::FootholdTree() {
+    void FootholdTree::build_columns() {
+        int16_t left = 30000;
+        int16_t right = -30000;
+
+        for (const Foothold& fh : footholds) {
+            if (fh.id() == 0 || fh.is_wall())
+                continue;
+
+            if (fh.l() < left)
+                left = fh.l();
+
+            if (fh.r() > right)
+                right = fh.r();
+        }
+
+        if (left > right)
+            return;
+
+        column_origin = left;
+
+        size_t numcolumns = (right - left) / COLUMNWIDTH + 1;
+        column_starts.assign(numcolumns + 1, 0);
+
+        // Count the footholds in each column, then turn the counts into offsets
+        for (const Foothold& fh : footholds) {
+            if (fh.id() == 0 || fh.is_wall())
+                continue;
+
+            size_t first = (fh.l() - column_origin) / COLUMNWIDTH;
+            size_t last = (fh.r() - column_origin) / COLUMNWIDTH;
+
+            for (size_t i = first; i <= last; i++)
+                column_starts[i + 1]++;
+        }
+
+        for (size_t i = 1; i <= numcolumns; i++)
+            column_starts[i] += column_starts[i - 1];
+
+        column_footholds.resize(column_starts[numcolumns]);
+
+        std::vector<uint32_t> fill(column_starts.begin(), column_starts.end() - 1);
+
+        for (const Foothold& fh : footholds) {
+            if (fh.id() == 0 || fh.is_wall())
+                continue;
+
+            size_t first = (fh.l() - column_origin) / COLUMNWIDTH;
+            size_t last = (fh.r() - column_origin) / COLUMNWIDTH;
+
+            for (size_t i = first; i <= last; i++)
+                column_footholds[fill[i]++] = fh.id();
+        }
     }
 
     void FootholdTree::limit_movement(PhysicsObject& phobj) const {
@@ -240,12 +310,10 @@ namespace ms {
     }
 
     const Foothold& FootholdTree::get_fh(uint16_t fhid) const {
-        auto iter = footholds.find(fhid);
-
-        if (iter == footholds.end())
+        if (fhid >= footholds.size())
             return nullfh;
 
-        return iter->second;
+        return footholds[fhid];
     }
 
     double FootholdTree::get_wall(uint16_t curid, bool left, double fy) const {
@@ -315,10 +383,21 @@ namespace ms {
         double comp = borders.second();
 
         int16_t x = static_cast<int16_t>(fx);
-        auto range = footholdsbyx.equal_range(x);
 
-        for (auto iter = range.first; iter != range.second; ++iter) {
-            const Foothold& fh = footholds.at(iter->second);
+        if (x < column_origin || column_starts.empty())
+            return ret;
+
+        size_t column = (x - column_origin) / COLUMNWIDTH;
+
+        if (column + 1 >= column_starts.size())
+            return ret;
+
+        for (uint32_t i = column_starts[column]; i < column_starts[column + 1]; i++) {
+            const Foothold& fh = footholds[column_footholds[i]];
+
+            if (x < fh.l() || x > fh.r())
+                continue;
+
             double ycomp = fh.ground_below(fx);
 
             if (comp >= ycomp && ycomp >= fy) {
@@ -20,7 +20,7 @@
 #include "Foothold.h"
 #include "PhysicsObject.h"
 
-#include <unordered_map>
+#include <vector>
 
 namespace ms {
     // The collection of platforms in a maple map
@@ -28,6 +28,8 @@ namespace ms {
     class FootholdTree {
     public:
         FootholdTree(nl::node source);
+        // Build the tree from footholds which were loaded elsewhere, footholds with a duplicate id are skipped
+        FootholdTree(const std::vector<Foothold>& source);
         FootholdTree();
 
         // Takes an accelerated PhysicsObject and limits its movement based on the platforms in this tree
@@ -40,15 +42,28 @@ namespace ms {
         Range<int16_t> get_walls(bool camera) const;
         // Returns the topmost and bottommost platform positions of the map
         Range<int16_t> get_borders() const;
-
-    private:
+        // Returns the id of the closest platform at or below the specified position, or 0 if there is none
         uint16_t get_fhid_below(double fx, double fy) const;
+        // Returns the x-coordinate at which a wall next to the platform stops horizontal movement
         double get_wall(uint16_t fhid, bool left, double fy) const;
+        // Returns the x-coordinate of the edge near the platform, for objects which turn at edges
         double get_edge(uint16_t fhid, bool left) const;
+
+    private:
         const Foothold& get_fh(uint16_t fhid) const;
 
-        std::unordered_map<uint16_t, Foothold> footholds;
-        std::unordered_multimap<int16_t, uint16_t> footholdsbyx;
+        void add(const Foothold& foothold);
+        void build_bounds();
+        void build_columns();
+
+        // Footholds indexed by their id, unused ids hold an empty foothold
+        std::vector<Foothold> footholds;
+
+        // Non-wall footholds bucketed into fixed-width columns of the map
+        // The ids for column i are column_footholds[column_starts[i]] to column_footholds[column_starts[i + 1]]
+        int16_t column_origin;
+        std::vector<uint32_t> column_starts;
+        std::vector<uint16_t> column_footholds;
 
         Foothold nullfh;
         Range<int16_t> walls;
@@ -70,6 +70,188 @@ namespace ms {
         phobj.move();
     }
 
+    void Physics::move_objects(PhysicsBatch& batch) const {
+        auto& free = batch.free;
+        auto& ground = batch.ground;
+
+        free.clear();
+        ground.clear();
+
+        // Determine platforms and sort the objects into lanes by the physics they use
+        for (PhysicsObject* phobj : batch.objects) {
+            fht.update_fh(*phobj);
+
+            bool gravity = phobj->is_flag_not_set(PhysicsObject::Flag::NO_GRAVITY);
+
+            switch (phobj->type) {
+            case PhysicsObject::Type::NORMAL:
+                if (phobj->is_on_ground) {
+                    gather_ground(ground, *phobj);
+                } else {
+                    // Forces are ignored while in the air
+                    phobj->h_force = 0.0;
+                    phobj->v_force = 0.0;
+
+                    gather_free(free, *phobj, 0.0, gravity ? GRAVFORCE : 0.0, TERMINAL_VELOCITY, false);
+                }
+
+                break;
+            case PhysicsObject::Type::FALLING:
+                move_falling(*phobj);
+                break;
+            case PhysicsObject::Type::FLYING:
+                gather_free(free, *phobj, FLYFRICTION, 0.0, HUGE_VAL, true);
+                break;
+            case PhysicsObject::Type::SWIMMING:
+                gather_free(free, *phobj, SWIMFRICTION, gravity ? SWIMGRAVFORCE : 0.0, HUGE_VAL, true);
+                break;
+            case PhysicsObject::Type::FIXATED:
+            default:
+                break;
+            }
+        }
+
+        integrate_free(free);
+        integrate_ground(ground);
+
+        for (size_t i = 0; i < free.size(); i++) {
+            PhysicsObject& phobj = *free.objects[i];
+            phobj.h_force = 0.0;
+            phobj.v_force = 0.0;
+            phobj.h_acceleration = free.h_acceleration[i];
+            phobj.v_acceleration = free.v_acceleration[i];
+            phobj.h_speed = free.h_speed[i];
+            phobj.v_speed = free.v_speed[i];
+        }
+
+        for (size_t i = 0; i < ground.size(); i++) {
+            PhysicsObject& phobj = *ground.objects[i];
+            phobj.h_force = 0.0;
+            phobj.v_force = 0.0;
+            phobj.h_acceleration = ground.h_acceleration[i];
+            phobj.v_acceleration = ground.v_acceleration[i];
+            phobj.h_speed = ground.h_speed[i];
+            phobj.v_speed = ground.v_speed[i];
+        }
+
+        // Collision and movement depend on the footholds, so they stay per object
+        for (PhysicsObject* phobj : batch.objects) {
+            switch (phobj->type) {
+            case PhysicsObject::Type::NORMAL:
+            case PhysicsObject::Type::FALLING:
+            case PhysicsObject::Type::FLYING:
+            case PhysicsObject::Type::SWIMMING:
+                fht.limit_movement(*phobj);
+                break;
+            default:
+                break;
+            }
+
+            phobj->move();
+        }
+    }
+
+    void Physics::gather_free(PhysicsBatch::FreeLanes& lanes, PhysicsObject& phobj, double friction, double gravity,
+                              double terminal, bool snap) const {
+        lanes.objects.push_back(&phobj);
+        lanes.h_force.push_back(phobj.h_force);
+        lanes.v_force.push_back(phobj.v_force);
+        lanes.h_speed.push_back(phobj.h_speed);
+        lanes.v_speed.push_back(phobj.v_speed);
+        lanes.friction.push_back(friction);
+        lanes.gravity.push_back(gravity);
+        lanes.terminal.push_back(terminal);
+        lanes.snap.push_back(snap);
+    }
+
+    void Physics::gather_ground(PhysicsBatch::GroundLanes& lanes, PhysicsObject& phobj) const {
+        double slopef = phobj.fh_slope;
+
+        // If the slope isn't steep we don't reduce or increase acceleration at all
+        if (slopef > -0.5 && slopef < 0.5)
+            slopef = 0.0;
+
+        double slope_friction = 1.0;
+
+        // If going uphill, decrease inertia relative to angle of slope
+        if ((slopef < 0.0 && phobj.h_speed > 0.0) || (slopef > 0.0 && phobj.h_speed < 0.0))
+            slope_friction = cos(slopef * SLOPE_FRICTION_FACTOR);
+
+        lanes.objects.push_back(&phobj);
+        lanes.h_force.push_back(phobj.h_force);
+        lanes.v_force.push_back(phobj.v_force);
+        lanes.h_speed.push_back(phobj.h_speed);
+        lanes.v_speed.push_back(phobj.v_speed);
+        lanes.slope.push_back(slopef);
+        lanes.slope_friction.push_back(slope_friction);
+    }
+
+    void Physics::integrate_free(PhysicsBatch::FreeLanes& lanes) const {
+        size_t count = lanes.size();
+
+        lanes.h_acceleration.resize(count);
+        lanes.v_acceleration.resize(count);
+
+        const double* h_force = lanes.h_force.data();
+        const double* v_force = lanes.v_force.data();
+        const double* friction = lanes.friction.data();
+        const double* gravity = lanes.gravity.data();
+        const double* terminal = lanes.terminal.data();
+        const uint8_t* snap = lanes.snap.data();
+        double* h_speed = lanes.h_speed.data();
+        double* v_speed = lanes.v_speed.data();
+        double* h_acceleration = lanes.h_acceleration.data();
+        double* v_acceleration = lanes.v_acceleration.data();
+
+        // Same steps as move_flying and move_swimming, written without branches over plain arrays
+        for (size_t i = 0; i < count; i++) {
+            double hacc = h_force[i] - friction[i] * h_speed[i];
+            double vacc = v_force[i] - friction[i] * v_speed[i] + gravity[i];
+            double hspeed = h_speed[i] + hacc;
+            double vspeed = std::fmin(v_speed[i] + vacc, terminal[i]);
+
+            bool hstop = snap[i] && hacc == 0.0 && hspeed < 0.1 && hspeed > -0.1;
+            bool vstop = snap[i] && vacc == 0.0 && vspeed < 0.1 && vspeed > -0.1;
+
+            h_acceleration[i] = hacc;
+            v_acceleration[i] = vacc;
+            h_speed[i] = hstop ? 0.0 : hspeed;
+            v_speed[i] = vstop ? 0.0 : vspeed;
+        }
+    }
+
+    void Physics::integrate_ground(PhysicsBatch::GroundLanes& lanes) const {
+        size_t count = lanes.size();
+
+        lanes.h_acceleration.resize(count);
+        lanes.v_acceleration.resize(count);
+
+        const double* h_force = lanes.h_force.data();
+        const double* v_force = lanes.v_force.data();
+        const double* slope = lanes.slope.data();
+        const double* slope_friction = lanes.slope_friction.data();
+        double* h_speed = lanes.h_speed.data();
+        double* v_speed = lanes.v_speed.data();
+        double* h_acceleration = lanes.h_acceleration.data();
+        double* v_acceleration = lanes.v_acceleration.data();
+
+        // Same steps as the on-ground branch of move_normal, written without branches over plain arrays
+        for (size_t i = 0; i < count; i++) {
+            double inertia = h_speed[i] / GROUNDSLIP;
+            double inertia_mult = FRICTION;
+            inertia_mult += FRICTION_FACTOR * (1.0 + SLOPE_INERTIA_FACTOR * (slope[i] * -inertia));
+            inertia_mult /= slope_friction[i];
+
+            bool stop = h_force[i] == 0.0 && h_speed[i] < 0.1 && h_speed[i] > -0.1;
+            double hacc = stop ? h_force[i] : h_force[i] - inertia_mult * inertia;
+
+            h_acceleration[i] = hacc;
+            v_acceleration[i] = v_force[i];
+            h_speed[i] = stop ? 0.0 : h_speed[i] + hacc;
+            v_speed[i] = std::fmin(v_speed[i] + v_force[i], TERMINAL_VELOCITY);
+        }
+    }
+
     void Physics::move_normal(PhysicsObject& phobj) const {
         phobj.v_acceleration = 0.0;
         phobj.h_acceleration = 0.0;
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "FootholdTree.h"
+#include "PhysicsBatch.h"
 
 namespace ms {
     // Class that uses physics engines and the collection of platforms to determine object movement
@@ -28,6 +29,8 @@ namespace ms {
 
         // Move the specified object over the specified game-time
         void move_object(PhysicsObject& tomove) const;
+        // Move all objects in the batch, integrating forces for the whole batch at once
+        void move_objects(PhysicsBatch& batch) const;
         // Determine the point on the ground below the specified position
         Point<int16_t> get_y_below(Point<int16_t> position) const;
         // Return a reference to the collection of platforms
@@ -39,6 +42,11 @@ namespace ms {
         void move_flying(PhysicsObject&) const;
         void move_swimming(PhysicsObject&) const;
 
+        void gather_free(PhysicsBatch::FreeLanes&, PhysicsObject&, double friction, double gravity, double terminal, bool snap) const;
+        void gather_ground(PhysicsBatch::GroundLanes&, PhysicsObject&) const;
+        void integrate_free(PhysicsBatch::FreeLanes&) const;
+        void integrate_ground(PhysicsBatch::GroundLanes&) const;
+
         FootholdTree fht;
     };
 }
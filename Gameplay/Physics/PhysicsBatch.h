@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "PhysicsObject.h"
+
+#include <vector>
+
+namespace ms {
+    // Structure-of-arrays buffer used to integrate many physics objects at once
+    // Filled and consumed by Physics::move_objects, kept around so the arrays are reused between ticks
+    struct PhysicsBatch {
+        // Objects that are integrated without ground friction: flying, swimming and airborne objects
+        struct FreeLanes {
+            std::vector<PhysicsObject*> objects;
+            std::vector<double> h_force;
+            std::vector<double> v_force;
+            std::vector<double> h_speed;
+            std::vector<double> v_speed;
+            std::vector<double> h_acceleration;
+            std::vector<double> v_acceleration;
+            std::vector<double> friction;
+            std::vector<double> gravity;
+            std::vector<double> terminal;
+            std::vector<uint8_t> snap;
+
+            void clear() {
+                objects.clear();
+                h_force.clear();
+                v_force.clear();
+                h_speed.clear();
+                v_speed.clear();
+                h_acceleration.clear();
+                v_acceleration.clear();
+                friction.clear();
+                gravity.clear();
+                terminal.clear();
+                snap.clear();
+            }
+
+            size_t size() const {
+                return objects.size();
+            }
+        };
+
+        // Objects standing on a foothold that use the normal physics engine
+        struct GroundLanes {
+            std::vector<PhysicsObject*> objects;
+            std::vector<double> h_force;
+            std::vector<double> v_force;
+            std::vector<double> h_speed;
+            std::vector<double> v_speed;
+            std::vector<double> h_acceleration;
+            std::vector<double> v_acceleration;
+            std::vector<double> slope;
+            std::vector<double> slope_friction;
+
+            void clear() {
+                objects.clear();
+                h_force.clear();
+                v_force.clear();
+                h_speed.clear();
+                v_speed.clear();
+                h_acceleration.clear();
+                v_acceleration.clear();
+                slope.clear();
+                slope_friction.clear();
+            }
+
+            size_t size() const {
+                return objects.size();
+            }
+        };
+
+        // All objects to move this tick
+        std::vector<PhysicsObject*> objects;
+        FreeLanes free;
+        GroundLanes ground;
+
+        void add(PhysicsObject& phobj) {
+            objects.push_back(&phobj);
+        }
+
+        void clear() {
+            objects.clear();
+            free.clear();
+            ground.clear();
+        }
+
+        bool empty() const {
+            return objects.empty();
+        }
+    };
+}
@@ -24,6 +24,7 @@
 #include "../IO/UITypes/UIStatusBar.h"
 #include "../Net/Packets/AttackAndSkillPackets.h"
 #include "../Net/Packets/GameplayPackets.h"
+#include "../Util/Profiler.h"
 
 #ifdef USE_NX
 #include <nlnx/nx.hpp>
@@ -32,10 +33,13 @@
 namespace ms {
     Stage::Stage() : combat(player, chars, mobs, reactors) {
         state = INACTIVE;
+        prefetch_cooldown = 0;
+        update_times = {};
     }
 
     void Stage::init() {
         drops.init();
+        combat.init();
     }
 
     void Stage::load(int32_t mapid, int8_t portalid) {
@@ -53,6 +57,10 @@ namespace ms {
         state = ACTIVE;
     }
 
+    void Stage::prefetch(int32_t mapid) {
+        loader.prefetch(mapid);
+    }
+
     void Stage::loadplayer(const CharEntry& entry) {
         player = entry;
         playable = player;
@@ -77,19 +85,15 @@ namespace ms {
     void Stage::load_map(int32_t mapid) {
         Stage::map_id = mapid;
 
-        std::string strid = string_format::extend_id(mapid, 9);
-        std::string prefix = std::to_string(mapid / 100000000);
+        std::unique_ptr<MapBundle> bundle = loader.take(mapid);
 
-        nl::node src = mapid == -1
-                           ? nl::nx::UI["CashShopPreview.img"]
-                           : nl::nx::Map["Map"]["Map" + prefix][strid + ".img"];
+        tilesobjs = std::move(bundle->tilesobjs);
+        backgrounds = std::move(bundle->backgrounds);
+        physics = std::move(bundle->physics);
+        map_info = std::move(bundle->map_info);
+        portals = std::move(bundle->portals);
 
-        tilesobjs = MapTilesObjs(src);
-        backgrounds = MapBackgrounds(src["back"]);
-        physics = Physics(src["foothold"]);
-        map_info = MapInfo(src, physics.get_fht().get_walls(true),
-                           physics.get_fht().get_borders());
-        portals = MapPortals(src["portal"], mapid);
+        prefetch_cooldown = PREFETCH_DELAY;
     }
 
     void Stage::respawn(int8_t portalid, bool transition) {
@@ -111,18 +115,26 @@ namespace ms {
         double viewx = viewrpos.x();
         double viewy = viewrpos.y();
 
-        backgrounds.draw_backgrounds(viewx, viewy, alpha);
+        {
+            PROFILE_SCOPE("Stage::draw backgrounds");
+            backgrounds.draw_backgrounds(viewx, viewy, alpha);
+        }
 
-        for (auto id : Layer::IDs) {
-            tilesobjs.draw(id, viewpos, alpha);
-            reactors.draw(id, viewx, viewy, alpha);
-            npcs.draw(id, viewx, viewy, alpha);
-            mobs.draw(id, viewx, viewy, alpha);
-            chars.draw(id, viewx, viewy, alpha);
-            player.draw(id, viewx, viewy, alpha);
-            drops.draw(id, viewx, viewy, alpha);
+        {
+            PROFILE_SCOPE("Stage::draw layers");
+
+            for (auto id : Layer::IDs) {
+                tilesobjs.draw(id, viewpos, alpha);
+                reactors.draw(id, viewx, viewy, alpha);
+                npcs.draw(id, viewx, viewy, alpha);
+                mobs.draw(id, viewx, viewy, alpha);
+                chars.draw(id, viewx, viewy, alpha);
+                player.draw(id, viewx, viewy, alpha);
+                drops.draw(id, viewx, viewy, alpha);
+            }
         }
 
+        PROFILE_SCOPE("Stage::draw effects");
         combat.draw(viewx, viewy, alpha);
         portals.draw(viewpos, alpha);
         backgrounds.draw_foregrounds(viewx, viewy, alpha);
@@ -133,21 +145,52 @@ namespace ms {
         if (state != ACTIVE)
             return;
 
+        PROFILE_SCOPE("Stage::update");
+
+        Profiler& profiler = Profiler::get();
+        int64_t last = profiler.now();
+
+        auto lap = [&](Subsystem subsystem) {
+            int64_t now = profiler.now();
+            update_times[subsystem] = now - last;
+
+            if (profiler.is_enabled())
+                profiler.record(nameof(subsystem), last, now);
+
+            last = now;
+        };
+
         combat.update();
+        lap(COMBAT);
+
         backgrounds.update();
         effect.update();
         tilesobjs.update();
+        lap(MAP);
 
         reactors.update(physics);
+        lap(REACTORS);
+
         npcs.update(physics);
+        lap(NPCS);
+
         mobs.update(physics);
+        lap(MOBS);
+
         chars.update(physics);
+        lap(CHARS);
+
         drops.update(physics);
+        lap(DROPS);
+
         player.update(physics);
 
         portals.update(player.get_position());
         camera.update(player.get_position());
 
+        prefetch_destinations();
+        lap(PLAYER);
+
         if (!player.is_climbing() && !player.is_sitting() && !player.is_attacking()) {
             if (player.is_key_down(KeyAction::Id::UP) && !player.is_key_down(KeyAction::Id::DOWN))
                 check_ladders(true);
@@ -168,6 +211,10 @@ namespace ms {
                 check_drops();
         }
 
+        lap(INPUT);
+
+        update_times[COLLISION] = 0;
+
         if (player.is_invincible())
             return;
 
@@ -177,6 +224,12 @@ namespace ms {
                 TakeDamagePacket(result, TakeDamagePacket::From::TOUCH).dispatch();
             }
         }
+
+        lap(COLLISION);
+    }
+
+    const std::array<int64_t, Stage::NUM_SUBSYSTEMS>& Stage::get_update_times() const {
+        return update_times;
     }
 
     void Stage::show_character_effect(int32_t cid, CharEffect::Id effect) {
@@ -184,6 +237,18 @@ namespace ms {
             character->show_effect_id(effect);
     }
 
+    void Stage::prefetch_destinations() {
+        if (prefetch_cooldown > 0) {
+            prefetch_cooldown--;
+            return;
+        }
+
+        prefetch_cooldown = PREFETCH_DELAY;
+
+        for (int32_t mapid : portals.get_destinations_near(player.get_position(), PREFETCH_RANGE))
+            loader.prefetch(mapid);
+    }
+
     void Stage::check_portals() {
         if (!player.can_portal())
             return;
@@ -17,6 +17,8 @@
 //////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include "MapLoader.h"
+
 #include "Combat/Combat.h"
 #include "MapleMap/MapBackgrounds.h"
 #include "MapleMap/MapDrops.h"
@@ -37,6 +39,39 @@ namespace ms {
             TRANSITION,
             ACTIVE
         };
+
+        // Parts of 'update()' which are timed separately
+        enum Subsystem : uint8_t {
+            COMBAT,
+            MAP,
+            REACTORS,
+            NPCS,
+            MOBS,
+            CHARS,
+            DROPS,
+            PLAYER,
+            INPUT,
+            COLLISION,
+            NUM_SUBSYSTEMS
+        };
+
+        static const char* nameof(Subsystem subsystem) {
+            static const char* subsystemnames[NUM_SUBSYSTEMS] =
+            {
+                "Stage::update combat",
+                "Stage::update map",
+                "Stage::update reactors",
+                "Stage::update npcs",
+                "Stage::update mobs",
+                "Stage::update chars",
+                "Stage::update drops",
+                "Stage::update player",
+                "Stage::update input",
+                "Stage::update collision"
+            };
+
+            return subsystemnames[subsystem];
+        }
     
         Stage();
 
@@ -44,6 +79,8 @@ namespace ms {
 
         // Loads the map to display
         void load(int32_t mapid, int8_t portalid);
+        // Start loading a map in the background so that a later 'load()' only has to swap it in
+        void prefetch(int32_t mapid);
         // Remove all map objects and graphics
         void clear(State new_state);
 
@@ -54,6 +91,8 @@ namespace ms {
         void draw(float alpha) const;
         // Calls 'update()' of all objects on stage
         void update();
+        // Return the time in nanoseconds that the last 'update()' spent in each subsystem
+        const std::array<int64_t, NUM_SUBSYSTEMS>& get_update_times() const;
 
         // Show a character effect
         void show_character_effect(int32_t cid, CharEffect::Id effect);
@@ -107,6 +146,10 @@ namespace ms {
         void check_seats();
         void check_ladders(bool up);
         void check_drops();
+        void prefetch_destinations();
+
+        static constexpr int16_t PREFETCH_RANGE = 300;
+        static constexpr uint16_t PREFETCH_DELAY = 125;
 
         Camera camera;
         Physics physics;
@@ -129,6 +172,11 @@ namespace ms {
 
         Combat combat;
 
+        MapLoader loader;
+        uint16_t prefetch_cooldown;
+
+        std::array<int64_t, NUM_SUBSYSTEMS> update_times;
+
         std::chrono::time_point<std::chrono::steady_clock> start;
         uint16_t levelBefore;
         int64_t expBefore;
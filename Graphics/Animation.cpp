@@ -21,6 +21,7 @@
 
 #include "../Util/Misc.h"
 
+#include <algorithm>
 #include <set>
 
 namespace ms {
@@ -107,7 +108,33 @@ namespace ms {
         return timestep * static_cast<float>(scales.second - scales.first) / delay;
     }
 
+    std::map<nl::node, std::weak_ptr<const Animation::Sequence>> Animation::sequences;
+    std::mutex Animation::sequencelock;
+    size_t Animation::prunesize = 1024;
+
     Animation::Animation(nl::node src) {
+        sequence = load(src);
+
+        reset();
+    }
+
+    Animation::Animation() {
+        sequence = empty();
+
+        reset();
+    }
+
+    std::shared_ptr<const Animation::Sequence> Animation::load(nl::node src) {
+        std::lock_guard<std::mutex> lock(sequencelock);
+
+        std::weak_ptr<const Sequence>& entry = sequences[src];
+
+        if (auto existing = entry.lock())
+            return existing;
+
+        auto loaded = std::make_shared<Sequence>();
+        std::vector<Frame>& frames = loaded->frames;
+
         bool istexture = src.data_type() == nl::node::type::bitmap;
 
         if (istexture) {
@@ -124,6 +151,8 @@ namespace ms {
                 }
             }
 
+            frames.reserve(frameids.size());
+
             for (auto& fid : frameids) {
                 auto sub = src[std::to_string(fid)];
                 frames.push_back(sub);
@@ -133,26 +162,35 @@ namespace ms {
                 frames.push_back(Frame());
         }
 
-        animated = frames.size() > 1;
-        zigzag = src["zigzag"].get_bool();
+        loaded->zigzag = src["zigzag"].get_bool();
 
-        reset();
-    }
+        entry = loaded;
 
-    Animation::Animation() {
-        animated = false;
-        zigzag = false;
+        if (sequences.size() >= prunesize) {
+            for (auto iter = sequences.begin(); iter != sequences.end();) {
+                if (iter->second.expired())
+                    iter = sequences.erase(iter);
+                else
+                    ++iter;
+            }
 
-        frames.push_back(Frame());
+            prunesize = std::max<size_t>(prunesize, sequences.size() * 2);
+        }
 
-        reset();
+        return loaded;
+    }
+
+    std::shared_ptr<const Animation::Sequence> Animation::empty() {
+        static const auto sequence = std::make_shared<const Sequence>(Sequence{{Frame()}, false});
+
+        return sequence;
     }
 
     void Animation::reset() {
         frame.set(0);
-        opacity.set(frames[0].start_opacity());
-        xyscale.set(frames[0].start_scale());
-        delay = frames[0].get_delay();
+        opacity.set(sequence->frames[0].start_opacity());
+        xyscale.set(sequence->frames[0].start_scale());
+        delay = sequence->frames[0].get_delay();
         framestep = 1;
     }
 
@@ -165,9 +203,9 @@ namespace ms {
         bool modifyscale = interscale != 1.0f;
 
         if (modifyopc || modifyscale)
-            frames[interframe].draw(args + DrawArgument(interscale, interscale, interopc));
+            sequence->frames[interframe].draw(args + DrawArgument(interscale, interscale, interopc));
         else
-            frames[interframe].draw(args);
+            sequence->frames[interframe].draw(args);
     }
 
     bool Animation::update() {
@@ -190,11 +228,11 @@ namespace ms {
             opacity.set(0.0f);
 
         if (timestep >= delay) {
-            int16_t lastframe = static_cast<int16_t>(frames.size() - 1);
+            int16_t lastframe = static_cast<int16_t>(sequence->frames.size() - 1);
             int16_t nextframe;
             bool ended;
 
-            if (zigzag && lastframe > 0) {
+            if (sequence->zigzag && lastframe > 0) {
                 if (framestep == 1 && frame == lastframe) {
                     framestep = -framestep;
                     ended = false;
@@ -220,13 +258,13 @@ namespace ms {
             float threshold = static_cast<float>(delta) / timestep;
             frame.next(nextframe, threshold);
 
-            delay = frames[nextframe].get_delay();
+            delay = sequence->frames[nextframe].get_delay();
 
             if (delay >= delta)
                 delay -= delta;
 
-            opacity.set(frames[nextframe].start_opacity());
-            xyscale.set(frames[nextframe].start_scale());
+            opacity.set(sequence->frames[nextframe].start_opacity());
+            xyscale.set(sequence->frames[nextframe].start_scale());
 
             return ended;
         }
@@ -238,17 +276,17 @@ namespace ms {
     }
 
     uint16_t Animation::get_delay(int16_t frame_id) const {
-        return frame_id < frames.size() ? frames[frame_id].get_delay() : 0;
+        return frame_id < sequence->frames.size() ? sequence->frames[frame_id].get_delay() : 0;
     }
 
     uint16_t Animation::getdelayuntil(int16_t frame_id) const {
         uint16_t total = 0;
 
         for (int16_t i = 0; i < frame_id; i++) {
-            if (i >= frames.size())
+            if (i >= sequence->frames.size())
                 break;
 
-            total += frames[frame_id].get_delay();
+            total += sequence->frames[frame_id].get_delay();
         }
 
         return total;
@@ -271,6 +309,6 @@ namespace ms {
     }
 
     const Frame& Animation::get_frame() const {
-        return frames[frame.get()];
+        return sequence->frames[frame.get()];
     }
 }
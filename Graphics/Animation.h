@@ -22,6 +22,9 @@
 #include "../Template/Interpolated.h"
 #include "../Template/Rectangle.h"
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace ms {
@@ -53,6 +56,7 @@ namespace ms {
     };
 
     // Class which consists of multiple textures to make an Animation.
+    // The frames are loaded once per node and shared, each animation only keeps its own playback state.
     class Animation {
     public:
         Animation(nl::node source);
@@ -72,11 +76,20 @@ namespace ms {
         Rectangle<int16_t> get_bounds() const;
 
     private:
+        // The immutable frames of an animation
+        struct Sequence {
+            std::vector<Frame> frames;
+            bool zigzag;
+        };
+
+        // Return the sequence for a node, loading it if no other animation uses it
+        static std::shared_ptr<const Sequence> load(nl::node src);
+        // Return the sequence used by default-constructed animations
+        static std::shared_ptr<const Sequence> empty();
+
         const Frame& get_frame() const;
 
-        std::vector<Frame> frames;
-        bool animated;
-        bool zigzag;
+        std::shared_ptr<const Sequence> sequence;
 
         Nominal<int16_t> frame;
         Linear<float> opacity;
@@ -85,5 +98,10 @@ namespace ms {
         uint16_t delay;
         int16_t framestep;
         float opcstep;
+
+        // Sequences by their source node, expired entries are pruned when the cache has grown
+        static std::map<nl::node, std::weak_ptr<const Sequence>> sequences;
+        static std::mutex sequencelock;
+        static size_t prunesize;
     };
 }
@@ -0,0 +1,299 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "AtlasPacker.h"
+
+#include <chrono>
+
+namespace ms {
+    std::unique_ptr<AtlasPacker> AtlasPacker::create(Type type, int16_t width, int16_t height) {
+        switch (type) {
+        case Type::SKYLINE:
+            return std::make_unique<SkylinePacker>(width, height);
+        default:
+            return std::make_unique<LeftoverPacker>(width, height);
+        }
+    }
+
+    AtlasPacker::AtlasPacker(int16_t width, int16_t height) : region_width(width), region_height(height) {
+        used = 0;
+        wasted = 0;
+        inserts = 0;
+        insert_time = 0;
+    }
+
+    bool AtlasPacker::insert(int16_t width, int16_t height, Point<int16_t>& position) {
+        if (width <= 0 || height <= 0 || width > region_width || height > region_height)
+            return false;
+
+        auto start = std::chrono::steady_clock::now();
+        bool placed = place(width, height, position);
+        auto end = std::chrono::steady_clock::now();
+
+        insert_time += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+        if (placed) {
+            used += static_cast<size_t>(width) * height;
+            inserts++;
+        }
+
+        return placed;
+    }
+
+    void AtlasPacker::clear() {
+        used = 0;
+        wasted = 0;
+
+        reset();
+    }
+
+    size_t AtlasPacker::get_used() const {
+        return used;
+    }
+
+    size_t AtlasPacker::get_wasted() const {
+        return wasted;
+    }
+
+    double AtlasPacker::get_fill() const {
+        return static_cast<double>(used) / (static_cast<size_t>(region_width) * region_height);
+    }
+
+    size_t AtlasPacker::get_inserts() const {
+        return inserts;
+    }
+
+    int64_t AtlasPacker::get_insert_time() const {
+        return insert_time;
+    }
+
+    LeftoverPacker::LeftoverPacker(int16_t width, int16_t height) : AtlasPacker(width, height) {
+        leftovers = QuadTree<size_t, Leftover>(
+            [](const Leftover& first, const Leftover& second) {
+                bool width_comparison = first.width() >= second.width();
+                bool height_comparison = first.height() >= second.height();
+
+                if (width_comparison && height_comparison)
+                    return QuadTree<size_t, Leftover>::Direction::RIGHT;
+                if (width_comparison)
+                    return QuadTree<size_t, Leftover>::Direction::DOWN;
+                if (height_comparison)
+                    return QuadTree<size_t, Leftover>::Direction::UP;
+                return QuadTree<size_t, Leftover>::Direction::LEFT;
+            }
+        );
+
+        reset();
+    }
+
+    bool LeftoverPacker::place(int16_t width, int16_t height, Point<int16_t>& position) {
+        auto value = Leftover(0, 0, width, height);
+
+        size_t lid = leftovers.findnode(
+            value,
+            [](const Leftover& val, const Leftover& leaf) {
+                return val.width() <= leaf.width() && val.height() <= leaf.height();
+            }
+        );
+
+        if (lid > 0) {
+            const Leftover& leftover = leftovers[lid];
+
+            int16_t x = leftover.left;
+            int16_t y = leftover.top;
+
+            int16_t width_delta = leftover.width() - width;
+            int16_t height_delta = leftover.height() - height;
+
+            leftovers.erase(lid);
+
+            wasted -= width * height;
+
+            if (width_delta >= MINLOSIZE && height_delta >= MINLOSIZE) {
+                leftovers.add(rlid, Leftover(x + width, y + height, width_delta, height_delta));
+                rlid++;
+
+                if (width >= MINLOSIZE) {
+                    leftovers.add(rlid, Leftover(x, y + height, width, height_delta));
+                    rlid++;
+                }
+
+                if (height >= MINLOSIZE) {
+                    leftovers.add(rlid, Leftover(x + width, y, width_delta, height));
+                    rlid++;
+                }
+            } else if (width_delta >= MINLOSIZE) {
+                leftovers.add(rlid, Leftover(x + width, y, width_delta, height + height_delta));
+                rlid++;
+            } else if (height_delta >= MINLOSIZE) {
+                leftovers.add(rlid, Leftover(x, y + height, width + width_delta, height_delta));
+                rlid++;
+            }
+
+            position = Point<int16_t>(x, y);
+
+            return true;
+        }
+
+        if (border.x() + width > region_width) {
+            if (border.y() + rowheight + height > region_height)
+                return false;
+
+            border.set_x(0);
+            border.shift_y(rowheight);
+            rowbottom = 0;
+            rowheight = 0;
+        } else if (border.y() + height > region_height) {
+            return false;
+        }
+
+        int16_t x = border.x();
+        int16_t y = border.y();
+
+        border.shift_x(width);
+
+        if (height > rowheight) {
+            if (x >= MINLOSIZE && height - rowheight >= MINLOSIZE) {
+                leftovers.add(rlid, Leftover(0, rowbottom, x, height - rowheight));
+                rlid++;
+            }
+
+            wasted += x * (height - rowheight);
+
+            rowbottom = y + height;
+            rowheight = height;
+        } else if (height < rowbottom - y) {
+            if (width >= MINLOSIZE && rowbottom - y - height >= MINLOSIZE) {
+                leftovers.add(rlid, Leftover(x, y + height, width, rowbottom - y - height));
+                rlid++;
+            }
+
+            wasted += width * (rowbottom - y - height);
+        }
+
+        position = Point<int16_t>(x, y);
+
+        return true;
+    }
+
+    void LeftoverPacker::reset() {
+        leftovers.clear();
+        rlid = 1;
+        border = Point<int16_t>(0, 0);
+        rowbottom = 0;
+        rowheight = 0;
+    }
+
+    SkylinePacker::SkylinePacker(int16_t width, int16_t height) : AtlasPacker(width, height) {
+        reset();
+    }
+
+    int16_t SkylinePacker::fit(size_t index, int16_t width, int16_t height) const {
+        int16_t x = skyline[index].x;
+
+        if (x + width > region_width)
+            return -1;
+
+        int16_t y = 0;
+        int16_t remaining = width;
+
+        for (size_t i = index; remaining > 0 && i < skyline.size(); i++) {
+            if (skyline[i].y > y)
+                y = skyline[i].y;
+
+            if (y + height > region_height)
+                return -1;
+
+            remaining -= skyline[i].width;
+        }
+
+        return y;
+    }
+
+    bool SkylinePacker::place(int16_t width, int16_t height, Point<int16_t>& position) {
+        size_t best = skyline.size();
+        int16_t best_top = region_height + 1;
+        int16_t best_width = region_width + 1;
+        int16_t best_y = 0;
+
+        for (size_t i = 0; i < skyline.size(); i++) {
+            int16_t y = fit(i, width, height);
+
+            if (y < 0)
+                continue;
+
+            int16_t top = y + height;
+
+            if (top < best_top || (top == best_top && skyline[i].width < best_width)) {
+                best = i;
+                best_top = top;
+                best_width = skyline[i].width;
+                best_y = y;
+            }
+        }
+
+        if (best == skyline.size())
+            return false;
+
+        int16_t x = skyline[best].x;
+        int16_t right = x + width;
+
+        // Count the area below the new rectangle which can no longer be reached
+        for (size_t i = best; i < skyline.size() && skyline[i].x < right; i++) {
+            int16_t overlap = std::min<int16_t>(skyline[i].x + skyline[i].width, right) - skyline[i].x;
+
+            wasted += static_cast<size_t>(overlap) * (best_y - skyline[i].y);
+        }
+
+        skyline.insert(skyline.begin() + best, {x, best_top, width});
+
+        for (size_t i = best + 1; i < skyline.size();) {
+            Segment& segment = skyline[i];
+
+            if (segment.x >= right)
+                break;
+
+            int16_t shrink = right - segment.x;
+
+            if (segment.width <= shrink) {
+                skyline.erase(skyline.begin() + i);
+            } else {
+                segment.x += shrink;
+                segment.width -= shrink;
+                break;
+            }
+        }
+
+        for (size_t i = 0; i + 1 < skyline.size();) {
+            if (skyline[i].y == skyline[i + 1].y) {
+                skyline[i].width += skyline[i + 1].width;
+                skyline.erase(skyline.begin() + i + 1);
+            } else {
+                i++;
+            }
+        }
+
+        position = Point<int16_t>(x, best_y);
+
+        return true;
+    }
+
+    void SkylinePacker::reset() {
+        skyline.clear();
+        skyline.push_back({0, 0, region_width});
+    }
+}
@@ -0,0 +1,144 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "../Template/Point.h"
+#include "../Util/QuadTree.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ms {
+    // Rectangle packer for a single region of the texture atlas
+    // Has no dependency on OpenGL so it can be used without a context
+    class AtlasPacker {
+    public:
+        enum Type : uint8_t {
+            LEFTOVER,
+            SKYLINE,
+            NUM_TYPES
+        };
+
+        // Create a packer of the given type for a region of the specified size
+        static std::unique_ptr<AtlasPacker> create(Type type, int16_t width, int16_t height);
+
+        AtlasPacker(int16_t width, int16_t height);
+        virtual ~AtlasPacker() {
+        }
+
+        // Find space for a rectangle, returns false if the region is full
+        bool insert(int16_t width, int16_t height, Point<int16_t>& position);
+        // Remove all rectangles from the region
+        void clear();
+
+        // Return the area covered by inserted rectangles
+        size_t get_used() const;
+        // Return the area which can no longer be used
+        size_t get_wasted() const;
+        // Return the fraction of the region covered by inserted rectangles
+        double get_fill() const;
+        // Return the number of successful inserts since creation
+        size_t get_inserts() const;
+        // Return the total time spent in insert since creation, in nanoseconds
+        int64_t get_insert_time() const;
+
+    protected:
+        virtual bool place(int16_t width, int16_t height, Point<int16_t>& position) = 0;
+        virtual void reset() = 0;
+
+        int16_t region_width;
+        int16_t region_height;
+        size_t used;
+        size_t wasted;
+
+    private:
+        size_t inserts;
+        int64_t insert_time;
+    };
+
+    // Shelf packer which keeps a tree of the leftover space below and beside each shelf
+    class LeftoverPacker : public AtlasPacker {
+    public:
+        LeftoverPacker(int16_t width, int16_t height);
+
+    protected:
+        bool place(int16_t width, int16_t height, Point<int16_t>& position) override;
+        void reset() override;
+
+    private:
+        static constexpr int16_t MINLOSIZE = 32;
+
+        struct Leftover {
+            int16_t left;
+            int16_t right;
+            int16_t top;
+            int16_t bottom;
+
+            Leftover(int16_t x, int16_t y, int16_t width, int16_t height) {
+                left = x;
+                right = x + width;
+                top = y;
+                bottom = y + height;
+            }
+
+            Leftover() {
+                left = 0;
+                right = 0;
+                top = 0;
+                bottom = 0;
+            }
+
+            int16_t width() const {
+                return right - left;
+            }
+
+            int16_t height() const {
+                return bottom - top;
+            }
+        };
+
+        QuadTree<size_t, Leftover> leftovers;
+        size_t rlid;
+        Point<int16_t> border;
+        int16_t rowbottom;
+        int16_t rowheight;
+    };
+
+    // Bottom-left skyline packer
+    class SkylinePacker : public AtlasPacker {
+    public:
+        SkylinePacker(int16_t width, int16_t height);
+
+    protected:
+        bool place(int16_t width, int16_t height, Point<int16_t>& position) override;
+        void reset() override;
+
+    private:
+        struct Segment {
+            int16_t x;
+            int16_t y;
+            int16_t width;
+        };
+
+        // Return the lowest y at which a rectangle fits starting at the given segment, or -1
+        int16_t fit(size_t index, int16_t width, int16_t height) const;
+
+        std::vector<Segment> skyline;
+    };
+}
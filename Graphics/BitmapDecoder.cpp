@@ -0,0 +1,132 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "BitmapDecoder.h"
+
+#include <cstring>
+
+namespace ms {
+    BitmapDecoder::BitmapDecoder() {
+        running = false;
+    }
+
+    BitmapDecoder::~BitmapDecoder() {
+        stop();
+    }
+
+    void BitmapDecoder::start() {
+        if (running)
+            return;
+
+        running = true;
+        worker = std::thread(&BitmapDecoder::run, this);
+    }
+
+    void BitmapDecoder::stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            running = false;
+            requests.clear();
+            decoded.clear();
+        }
+
+        condition.notify_all();
+
+        if (worker.joinable())
+            worker.join();
+    }
+
+    bool BitmapDecoder::is_running() const {
+        return running;
+    }
+
+    void BitmapDecoder::request(const nl::bitmap& bmp) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            requests.push_back(bmp);
+        }
+
+        condition.notify_one();
+    }
+
+    bool BitmapDecoder::poll(Block& block) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (decoded.empty())
+            return false;
+
+        block = std::move(decoded.front());
+        decoded.pop_front();
+
+        return true;
+    }
+
+    void BitmapDecoder::recycle(std::vector<uint8_t>&& pixels) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (buffers.size() < MAXBUFFERS)
+            buffers.push_back(std::move(pixels));
+    }
+
+    void BitmapDecoder::run() {
+        while (true) {
+            nl::bitmap bmp;
+            std::vector<uint8_t> pixels;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                condition.wait(lock, [&]() {
+                    return !running || !requests.empty();
+                });
+
+                if (!running)
+                    return;
+
+                bmp = requests.front();
+                requests.pop_front();
+
+                if (!buffers.empty()) {
+                    pixels = std::move(buffers.back());
+                    buffers.pop_back();
+                }
+            }
+
+            const void* data = bmp.data();
+
+            if (!data)
+                continue;
+
+            pixels.resize(bmp.length());
+            std::memcpy(pixels.data(), data, pixels.size());
+
+            Block block = {
+                bmp.id(),
+                static_cast<int16_t>(bmp.width()),
+                static_cast<int16_t>(bmp.height()),
+                std::move(pixels)
+            };
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (running)
+                decoded.push_back(std::move(block));
+        }
+    }
+}
@@ -0,0 +1,77 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "../MapleStory.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef USE_NX
+#include <nlnx/bitmap.hpp>
+#endif
+
+namespace ms {
+    // Decodes bitmaps into RGBA blocks on a worker thread
+    // nl::bitmap::data() decompresses into a buffer shared by all bitmaps, so while the decoder
+    // is running it must be the only caller of that function
+    class BitmapDecoder {
+    public:
+        struct Block {
+            size_t id;
+            int16_t width;
+            int16_t height;
+            std::vector<uint8_t> pixels;
+        };
+
+        BitmapDecoder();
+        ~BitmapDecoder();
+
+        // Start the worker thread
+        void start();
+        // Stop the worker thread and drop all queued work
+        void stop();
+        // Return whether the worker thread is running
+        bool is_running() const;
+
+        // Queue a bitmap for decoding
+        void request(const nl::bitmap& bmp);
+        // Take the next decoded block, returns false if none is ready
+        bool poll(Block& block);
+        // Return the pixel storage of an uploaded block for reuse
+        void recycle(std::vector<uint8_t>&& pixels);
+
+    private:
+        void run();
+
+        static constexpr size_t MAXBUFFERS = 64;
+
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool running;
+
+        std::deque<nl::bitmap> requests;
+        std::deque<Block> decoded;
+        std::vector<std::vector<uint8_t>> buffers;
+    };
+}
@@ -17,22 +17,42 @@
 //////////////////////////////////////////////////////////////////////////////////
 #include "EffectLayer.h"
 
+#include "../Configuration.h"
+
+#include <algorithm>
+
 namespace ms {
+    void EffectLayer::init() {
+        capacity = Setting<EffectLimit>::get().load();
+    }
+
+    size_t EffectLayer::get_dropped() {
+        return dropped;
+    }
+
     void EffectLayer::draw_below(Point<int16_t> position, float alpha) const {
-        for (auto iter = effects.begin(); iter != effects.upper_bound(-1); ++iter)
-            for (auto& effect : iter->second)
+        for (auto& bucket : buckets) {
+            if (bucket.first >= 0)
+                break;
+
+            for (auto& effect : bucket.second)
                 effect.draw(position, alpha);
+        }
     }
 
     void EffectLayer::drawabove(Point<int16_t> position, float alpha) const {
-        for (auto iter = effects.upper_bound(-1); iter != effects.end(); ++iter)
-            for (auto& effect : iter->second)
+        for (auto& bucket : buckets) {
+            if (bucket.first < 0)
+                continue;
+
+            for (auto& effect : bucket.second)
                 effect.draw(position, alpha);
+        }
     }
 
     void EffectLayer::update() {
-        for (auto& effectlist : effects) {
-            effectlist.second.remove_if(
+        for (auto& bucket : buckets) {
+            bucket.second.remove_if(
                 [](Effect& effect) {
                     return effect.update();
                 }
@@ -41,7 +61,8 @@ namespace ms {
     }
 
     void EffectLayer::add(const Animation& animation, const DrawArgument& args, int8_t z, float speed) {
-        effects[z].emplace_back(animation, args, speed);
+        if (!get_bucket(z).emplace(animation, args, speed))
+            dropped++;
     }
 
     void EffectLayer::add(const Animation& animation, const DrawArgument& args, int8_t z) {
@@ -55,4 +76,21 @@ namespace ms {
     void EffectLayer::add(const Animation& animation) {
         add(animation, {}, 0, 1.0f);
     }
+
+    Pool<EffectLayer::Effect>& EffectLayer::get_bucket(int8_t z) {
+        auto iter = std::lower_bound(
+            buckets.begin(), buckets.end(), z,
+            [](const std::pair<int8_t, Pool<Effect>>& bucket, int8_t value) {
+                return bucket.first < value;
+            }
+        );
+
+        if (iter == buckets.end() || iter->first != z)
+            iter = buckets.emplace(iter, z, Pool<Effect>(capacity));
+
+        return iter->second;
+    }
+
+    size_t EffectLayer::capacity = 64;
+    size_t EffectLayer::dropped = 0;
 }
@@ -21,13 +21,18 @@
 
 #include "../Constants.h"
 
-#include <map>
-#include <list>
+#include "../Template/Pool.h"
 
 namespace ms {
     // A list of animations. Animations will be removed after all frames were displayed.
+    // Effects are kept in one pool per z value, effects added to a full pool are dropped.
     class EffectLayer {
     public:
+        // Load the maximum number of effects per z value
+        static void init();
+        // Return the number of effects which were dropped by all layers
+        static size_t get_dropped();
+
         void draw_below(Point<int16_t> position, float alpha) const;
         void drawabove(Point<int16_t> position, float alpha) const;
         void update();
@@ -57,6 +62,13 @@ namespace ms {
             float speed;
         };
 
-        std::map<int8_t, std::list<Effect>> effects;
+        // Return the pool for a z value, creating it if needed
+        Pool<Effect>& get_bucket(int8_t z);
+
+        // Pools sorted by their z value
+        std::vector<std::pair<int8_t, Pool<Effect>>> buckets;
+
+        static size_t capacity;
+        static size_t dropped;
     };
 }
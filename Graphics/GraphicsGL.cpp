@@ -18,10 +18,31 @@
 #include "GraphicsGL.h"
 
 #include "../Configuration.h"
+#include "../Util/Profiler.h"
 
 namespace ms {
     GraphicsGL::GraphicsGL() {
         locked = false;
+        frame = 0;
+        evicted = 0;
+        evictions = 0;
+        generation = 0;
+
+        batching = false;
+        recording = false;
+        nextbatch = 1;
+
+        indexed = false;
+        indexcapacity = 0;
+        vbosize = 0;
+
+        for (FT_Face& face : faces)
+            face = nullptr;
+
+        glyphtop = 0;
+        glyphevictions = 0;
+        layouthits = 0;
+        layoutmisses = 0;
 
         VWIDTH = Constants::Constants::get().get_view_width();
         VHEIGHT = Constants::Constants::get().get_view_height();
@@ -38,12 +59,12 @@ namespace ms {
             "varying vec2 texpos;"
             "varying vec4 colormod;"
             "uniform vec2 screensize;"
-            "uniform int yoffset;"
+            "uniform vec2 viewoffset;"
 
             "void main(void)"
             "{"
-            "	float x = -1.0 + coord.x * 2.0 / screensize.x;"
-            "	float y = 1.0 - (coord.y + yoffset) * 2.0 / screensize.y;"
+            "	float x = -1.0 + (coord.x + viewoffset.x) * 2.0 / screensize.x;"
+            "	float y = 1.0 - (coord.y + viewoffset.y) * 2.0 / screensize.y;"
             "   gl_Position = vec4(x, y, 0.0, 1.0);"
             "	texpos = coord.zw;"
             "	colormod = color;"
@@ -80,6 +101,8 @@ namespace ms {
 
         // Initialize and configure
         // ------------------------
+        renderthread = std::this_thread::get_id();
+
         if (GLenum error = glewInit())
             return Error(Error::Code::GLEW, (const char*)glewGetErrorString(error));
 
@@ -163,16 +186,22 @@ namespace ms {
         uniform_texture = glGetUniformLocation(shaderProgram, "texture");
         uniform_atlassize = glGetUniformLocation(shaderProgram, "atlassize");
         uniform_screensize = glGetUniformLocation(shaderProgram, "screensize");
-        uniform_yoffset = glGetUniformLocation(shaderProgram, "yoffset");
+        uniform_viewoffset = glGetUniformLocation(shaderProgram, "viewoffset");
         uniform_fontregion = glGetUniformLocation(shaderProgram, "fontregion");
 
         if (attribute_coord == -1 || attribute_color == -1 || uniform_texture == -1 || uniform_atlassize == -1 ||
-            uniform_screensize == -1 || uniform_yoffset == -1)
+            uniform_screensize == -1 || uniform_viewoffset == -1)
             return Error::Code::SHADER_VARS;
 
         // Vertex Buffer Object
         glGenBuffers(1, &VBO);
 
+        // Index Buffer Object
+        indexed = Setting<IndexedQuads>::get().load();
+
+        if (indexed)
+            glGenBuffers(1, &IBO);
+
         glGenTextures(1, &atlas);
         glBindTexture(GL_TEXTURE_2D, atlas);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -206,20 +235,35 @@ namespace ms {
 
         fontymax += fontborder.y();
 
-        leftovers = QuadTree<size_t, Leftover>(
-            [](const Leftover& first, const Leftover& second) {
-                bool width_comparison = first.width() >= second.width();
-                bool height_comparison = first.height() >= second.height();
-
-                if (width_comparison && height_comparison)
-                    return QuadTree<size_t, Leftover>::Direction::RIGHT;
-                if (width_comparison)
-                    return QuadTree<size_t, Leftover>::Direction::DOWN;
-                if (height_comparison)
-                    return QuadTree<size_t, Leftover>::Direction::UP;
-                return QuadTree<size_t, Leftover>::Direction::LEFT;
-            }
-        );
+        // Characters outside of ASCII are rasterized on demand into a band of cells below the fonts
+        glyphtop = fontymax;
+        fontymax += GLYPHROWS * GLYPHCELL;
+
+        pageheight = static_cast<GLshort>((ATLASH - fontymax) / NUMPAGES);
+
+        auto packer = static_cast<AtlasPacker::Type>(Setting<AtlasPackerType>::get().load());
+
+        if (packer >= AtlasPacker::Type::NUM_TYPES)
+            packer = AtlasPacker::Type::LEFTOVER;
+
+        for (size_t i = 0; i < NUMPAGES; i++) {
+            pages[i].top = static_cast<GLshort>(fontymax + i * pageheight);
+            pages[i].packer = AtlasPacker::create(packer, ATLASW, pageheight);
+        }
+
+        std::string trace_path = Setting<AtlasTrace>::get().load();
+
+        if (!trace_path.empty())
+            atlastrace.open(trace_path, std::ios::app);
+
+        if (Setting<AsyncTextures>::get().load()) {
+            glGenBuffers(NUMPBOS, pbos);
+            pboindex = 0;
+
+            decoder.start();
+        }
+
+        batching = Setting<StaticBatches>::get().load();
 
         return Error::Code::NONE;
     }
@@ -289,6 +333,151 @@ namespace ms {
             ox += w;
         }
 
+        faces[id] = face;
+
+        return true;
+    }
+
+    uint32_t GraphicsGL::codepoint(const char* text, size_t pos, size_t last) {
+        const uint32_t REPLACEMENT = 0xFFFD;
+
+        auto lead = static_cast<uint8_t>(text[pos]);
+
+        if (lead < 0x80)
+            return lead;
+
+        if (lead < 0xC0)
+            return 0;
+
+        size_t length = lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+
+        if (pos + length > last)
+            return REPLACEMENT;
+
+        uint32_t result = lead & (0x7F >> length);
+
+        for (size_t i = 1; i < length; i++) {
+            auto next = static_cast<uint8_t>(text[pos + i]);
+
+            if ((next & 0xC0) != 0x80)
+                return REPLACEMENT;
+
+            result = result << 6 | (next & 0x3F);
+        }
+
+        return result;
+    }
+
+    GraphicsGL::Font::Char GraphicsGL::getglyph(Text::Font id, uint32_t cp, bool resident) {
+        if (cp < 128)
+            return fonts[id].chars[cp];
+
+        std::lock_guard<std::mutex> lock(glyphlock);
+
+        FT_Face face = faces[id];
+
+        if (!face)
+            return {};
+
+        uint64_t key = static_cast<uint64_t>(id) << 32 | cp;
+        auto iter = glyphs.find(key);
+        bool rendered = false;
+
+        if (iter == glyphs.end()) {
+            Font::Char metrics = {};
+
+            if (!FT_Load_Char(face, cp, FT_LOAD_RENDER)) {
+                FT_GlyphSlot g = face->glyph;
+
+                metrics.ax = static_cast<GLshort>(g->advance.x >> 6);
+                metrics.ay = static_cast<GLshort>(g->advance.y >> 6);
+                metrics.bl = static_cast<GLshort>(g->bitmap_left);
+                metrics.bt = static_cast<GLshort>(g->bitmap_top);
+                metrics.bw = std::min(static_cast<GLshort>(g->bitmap.width), GLYPHCELL);
+                metrics.bh = std::min(static_cast<GLshort>(g->bitmap.rows), GLYPHCELL);
+
+                rendered = true;
+            }
+
+            iter = glyphs.emplace(key, Glyph{metrics, NOCELL}).first;
+        }
+
+        Glyph& glyph = iter->second;
+
+        if (!resident || glyph.metrics.bw <= 0 || glyph.metrics.bh <= 0)
+            return glyph.metrics;
+
+        if (glyph.cell != NOCELL) {
+            GlyphCell& cell = glyphcells[glyph.cell];
+            cell.lastused = frame;
+            glyphlru.splice(glyphlru.begin(), glyphlru, cell.position);
+
+            return glyph.metrics;
+        }
+
+        if (!rendered && FT_Load_Char(face, cp, FT_LOAD_RENDER))
+            return glyph.metrics;
+
+        placeglyph(key, glyph, face->glyph->bitmap);
+
+        return glyph.metrics;
+    }
+
+    int16_t GraphicsGL::advance(Text::Font id, const char* text, size_t pos, size_t last) {
+        auto c = static_cast<uint8_t>(text[pos]);
+
+        if (c < 128)
+            return fonts[id].chars[c].ax;
+
+        uint32_t cp = codepoint(text, pos, last);
+
+        // The advance of a character is added at its first byte
+        if (cp == 0)
+            return 0;
+
+        return getglyph(id, cp, false).ax;
+    }
+
+    bool GraphicsGL::placeglyph(uint64_t key, Glyph& glyph, const FT_Bitmap& bitmap) {
+        size_t cell;
+
+        if (glyphcells.size() < NUMGLYPHCELLS) {
+            cell = glyphcells.size();
+            glyphlru.push_front(cell);
+            glyphcells.push_back({key, frame, glyphlru.begin()});
+        } else {
+            cell = glyphlru.back();
+            GlyphCell& oldest = glyphcells[cell];
+
+            // Never replace a glyph which is already on the screen
+            if (oldest.lastused == frame)
+                return false;
+
+            Glyph& replaced = glyphs.at(oldest.key);
+            replaced.cell = NOCELL;
+            replaced.metrics.offset = Offset();
+
+            glyphevictions++;
+
+            oldest.key = key;
+            oldest.lastused = frame;
+            glyphlru.splice(glyphlru.begin(), glyphlru, oldest.position);
+        }
+
+        constexpr size_t COLUMNS = ATLASW / GLYPHCELL;
+
+        auto x = static_cast<GLshort>(cell % COLUMNS * GLYPHCELL);
+        auto y = static_cast<GLshort>(glyphtop + cell / COLUMNS * GLYPHCELL);
+        GLshort w = glyph.metrics.bw;
+        GLshort h = glyph.metrics.bh;
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, bitmap.pitch);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, GL_RED, GL_UNSIGNED_BYTE, bitmap.buffer);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+        glyph.cell = cell;
+        glyph.metrics.offset = Offset(x, y, w, h);
+
         return true;
     }
 
@@ -307,10 +496,9 @@ namespace ms {
         glUniform1i(uniform_fontregion, fontymax);
         glUniform2f(uniform_atlassize, ATLASW, ATLASH);
         glUniform2f(uniform_screensize, VWIDTH, VHEIGHT);
+        glUniform2f(uniform_viewoffset, 0.0f, 0.0f);
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glVertexAttribPointer(attribute_coord, 4, GL_SHORT, GL_FALSE, sizeof(Quad::Vertex), nullptr);
-        glVertexAttribPointer(attribute_color, 4, GL_FLOAT, GL_FALSE, sizeof(Quad::Vertex), (const void*)8);
+        bindvertices(VBO);
 
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -323,130 +511,178 @@ namespace ms {
         clearinternal();
     }
 
-    void GraphicsGL::clearinternal() {
-        border = Point<GLshort>(0, fontymax);
-        yrange = Range<GLshort>();
+    void GraphicsGL::bindvertices(GLuint buffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glVertexAttribPointer(attribute_coord, 4, GL_SHORT, GL_FALSE, sizeof(Quad::Vertex), nullptr);
+        glVertexAttribPointer(attribute_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Quad::Vertex), (const void*)8);
+    }
 
+    void GraphicsGL::clearinternal() {
         offsets.clear();
-        leftovers.clear();
-        rlid = 1;
-        wasted = 0;
+
+        for (size_t i = 0; i < NUMPAGES; i++)
+            clearpage(i);
+    }
+
+    void GraphicsGL::clearpage(size_t id) {
+        Page& page = pages[id];
+
+        page.packer->clear();
+        page.bitmaps.clear();
+        page.lastused = 0;
+
+        generation++;
+    }
+
+    void GraphicsGL::evictpage(size_t id) {
+        Page& page = pages[id];
+
+        for (size_t bitmap : page.bitmaps)
+            offsets.erase(bitmap);
+
+        evicted += page.packer->get_used() * BYTESPERPIXEL;
+        evictions++;
+
+        LOG(LOG_TRACE, "Evicted atlas page [" << id << "] last used in frame [" << page.lastused << "]");
+
+        clearpage(id);
     }
 
     void GraphicsGL::clear() {
-        size_t used = ATLASW * border.y() + border.x() * yrange.second();
-        double usedpercent = static_cast<double>(used) / (ATLASW * ATLASH);
+        if (atlastrace.is_open())
+            atlastrace << "clear" << std::endl;
 
-        if (usedpercent > 80.0)
-            clearinternal();
+        for (size_t i = 0; i < NUMPAGES; i++)
+            if (pages[i].packer->get_fill() > CLEARFILL)
+                evictpage(i);
     }
 
-    void GraphicsGL::addbitmap(const nl::bitmap& bmp) {
-        getoffset(bmp);
+    GraphicsGL::AtlasStats GraphicsGL::get_atlas_stats() const {
+        AtlasStats stats = {
+            0, 0, evicted, evictions, 0, 0, pending.size(), glyphcells.size(), glyphevictions, layouthits, layoutmisses
+        };
+
+        for (const Page& page : pages) {
+            stats.used += page.packer->get_used() * BYTESPERPIXEL;
+            stats.wasted += page.packer->get_wasted() * BYTESPERPIXEL;
+            stats.inserts += page.packer->get_inserts();
+            stats.insert_time += page.packer->get_insert_time();
+        }
+
+        return stats;
     }
 
-    const GraphicsGL::Offset& GraphicsGL::getoffset(const nl::bitmap& bmp) {
-        size_t id = bmp.id();
-        auto offiter = offsets.find(id);
+    void GraphicsGL::addbitmap(const nl::bitmap& bmp) {
+        // Bitmaps created while loading maps in the background are added when they are first drawn
+        if (std::this_thread::get_id() != renderthread)
+            return;
 
-        if (offiter != offsets.end())
-            return offiter->second;
+        if (!decoder.is_running()) {
+            getoffset(bmp);
+            return;
+        }
 
-        GLshort x = 0;
-        GLshort y = 0;
+        size_t id = bmp.id();
         GLshort width = bmp.width();
         GLshort height = bmp.height();
 
-        if (width <= 0 || height <= 0)
-            return nulloffset;
-
-        auto value = Leftover(x, y, width, height);
+        if (width <= 0 || height <= 0 || width > ATLASW || height > pageheight)
+            return;
 
-        size_t lid = leftovers.findnode(
-            value,
-            [](const Leftover& val, const Leftover& leaf) {
-                return val.width() <= leaf.width() && val.height() <= leaf.height();
-            }
-        );
+        if (offsets.count(id) || !pending.insert(id).second)
+            return;
 
-        if (lid > 0) {
-            const Leftover& leftover = leftovers[lid];
+        decoder.request(bmp);
+    }
 
-            x = leftover.left;
-            y = leftover.top;
+    size_t GraphicsGL::pageof(const Offset& offset) const {
+        return static_cast<size_t>((offset.top - pages[0].top) / pageheight);
+    }
 
-            GLshort width_delta = leftover.width() - width;
-            GLshort height_delta = leftover.height() - height;
+    const GraphicsGL::Offset* GraphicsGL::findoffset(size_t id) {
+        auto offiter = offsets.find(id);
 
-            leftovers.erase(lid);
+        if (offiter == offsets.end())
+            return nullptr;
 
-            wasted -= width * height;
+        pages[pageof(offiter->second)].lastused = frame;
 
-            if (width_delta >= MINLOSIZE && height_delta >= MINLOSIZE) {
-                leftovers.add(rlid, Leftover(x + width, y + height, width_delta, height_delta));
-                rlid++;
+        return &offiter->second;
+    }
 
-                if (width >= MINLOSIZE) {
-                    leftovers.add(rlid, Leftover(x, y + height, width, height_delta));
-                    rlid++;
-                }
+    const GraphicsGL::Offset& GraphicsGL::getoffset(const nl::bitmap& bmp) {
+        if (const Offset* offset = findoffset(bmp.id()))
+            return *offset;
 
-                if (height >= MINLOSIZE) {
-                    leftovers.add(rlid, Leftover(x + width, y, width_delta, height));
-                    rlid++;
-                }
-            } else if (width_delta >= MINLOSIZE) {
-                leftovers.add(rlid, Leftover(x + width, y, width_delta, height + height_delta));
-                rlid++;
-            } else if (height_delta >= MINLOSIZE) {
-                leftovers.add(rlid, Leftover(x, y + height, width + width_delta, height_delta));
-                rlid++;
-            }
-        } else {
-            if (border.x() + width > ATLASW) {
-                border.set_x(0);
-                border.shift_y(yrange.second());
+        return upload(bmp.id(), bmp.width(), bmp.height(), bmp.data());
+    }
 
-                if (border.y() + height > ATLASH)
-                    clearinternal();
-                else
-                    yrange = Range<GLshort>();
-            }
+    const GraphicsGL::Offset& GraphicsGL::upload(size_t id, GLshort width, GLshort height, const void* pixels) {
+        PROFILE_SCOPE("GraphicsGL::upload");
 
-            x = border.x();
-            y = border.y();
+        if (width <= 0 || height <= 0)
+            return nulloffset;
 
-            border.shift_x(width);
+        if (width > ATLASW || height > pageheight) {
+            LOG(LOG_WARN, "Bitmap [" << id << "] of size [" << width << "x" << height << "] does not fit an atlas page");
 
-            if (height > yrange.second()) {
-                if (x >= MINLOSIZE && height - yrange.second() >= MINLOSIZE) {
-                    leftovers.add(rlid, Leftover(0, yrange.first(), x, height - yrange.second()));
-                    rlid++;
-                }
+            return nulloffset;
+        }
 
-                wasted += x * (height - yrange.second());
+        if (atlastrace.is_open())
+            atlastrace << width << ' ' << height << '\n';
 
-                yrange = Range<int16_t>(y + height, height);
-            } else if (height < yrange.first() - y) {
-                if (width >= MINLOSIZE && yrange.first() - y - height >= MINLOSIZE) {
-                    leftovers.add(rlid, Leftover(x, y + height, width, yrange.first() - y - height));
-                    rlid++;
-                }
+        Point<int16_t> position;
+        size_t pageid = NUMPAGES;
 
-                wasted += width * (yrange.first() - y - height);
+        for (size_t i = 0; i < NUMPAGES; i++) {
+            if (pages[i].packer->insert(width, height, position)) {
+                pageid = i;
+                break;
             }
         }
 
+        if (pageid == NUMPAGES) {
+            pageid = 0;
+
+            for (size_t i = 1; i < NUMPAGES; i++)
+                if (pages[i].lastused < pages[pageid].lastused)
+                    pageid = i;
+
+            evictpage(pageid);
+            pages[pageid].packer->insert(width, height, position);
+        }
+
+        Page& page = pages[pageid];
+        page.bitmaps.push_back(id);
+        page.lastused = frame;
+
+        GLshort x = position.x();
+        GLshort y = page.top + position.y();
+
 #if LOG_LEVEL >= LOG_TRACE
-		size_t used = ATLASW * border.y() + border.x() * yrange.second();
+		size_t pagesize = ATLASW * pageheight;
 
-		double usedpercent = static_cast<double>(used) / (ATLASW * ATLASH);
-		double wastedpercent = static_cast<double>(wasted) / used;
+		double usedpercent = page.packer->get_fill();
+		double wastedpercent = static_cast<double>(page.packer->get_wasted()) / pagesize;
 
-		LOG(LOG_TRACE, "Used: [" << usedpercent << "] Wasted: [" << wastedpercent << "]");
+		LOG(LOG_TRACE, "Page: [" << pageid << "] Used: [" << usedpercent << "] Wasted: [" << wastedpercent << "]");
 #endif
 
-        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_BGRA, GL_UNSIGNED_BYTE, bmp.data());
+        if (decoder.is_running()) {
+            // Stage the pixels in a pixel buffer so the driver can copy them to the atlas asynchronously
+            GLsizeiptr size = width * height * BYTESPERPIXEL;
+
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[pboindex]);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, size, pixels);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+            pboindex = (pboindex + 1) % NUMPBOS;
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_BGRA, GL_UNSIGNED_BYTE, pixels);
+        }
 
         return offsets.emplace(
             std::piecewise_construct,
@@ -455,8 +691,32 @@ namespace ms {
         ).first->second;
     }
 
+    void GraphicsGL::uploadpending() {
+        size_t uploaded = 0;
+        BitmapDecoder::Block block;
+
+        while (uploaded < UPLOADBUDGET && decoder.poll(block)) {
+            pending.erase(block.id);
+
+            if (!offsets.count(block.id)) {
+                upload(block.id, block.width, block.height, block.pixels.data());
+
+                uploaded += block.pixels.size();
+            }
+
+            decoder.recycle(std::move(block.pixels));
+        }
+    }
+
     void GraphicsGL::draw(const nl::bitmap& bmp, const Rectangle<int16_t>& rect, const Range<int16_t>& vertical,
                           const Range<int16_t>& horizontal, const Color& color, float angle) {
+        if (recording) {
+            if (!color.invisible())
+                batches[nextbatch].sprites.push_back({bmp, rect, vertical, horizontal, color, angle});
+
+            return;
+        }
+
         if (locked)
             return;
 
@@ -466,14 +726,30 @@ namespace ms {
         if (!rect.overlaps(SCREEN))
             return;
 
-        Offset offset = getoffset(bmp);
+        const Offset* resident = findoffset(bmp.id());
+
+        if (!resident) {
+            // Skip bitmaps which are still being decoded
+            if (decoder.is_running()) {
+                addbitmap(bmp);
+                return;
+            }
+
+            resident = &getoffset(bmp);
+        }
 
+        addquad(quads, *resident, rect, vertical, horizontal, color, angle);
+    }
+
+    void GraphicsGL::addquad(std::vector<Quad>& target, Offset offset, const Rectangle<int16_t>& rect,
+                             const Range<int16_t>& vertical, const Range<int16_t>& horizontal, const Color& color,
+                             float angle) {
         offset.top += vertical.first();
         offset.bottom -= vertical.second();
         offset.left += horizontal.first();
         offset.right -= horizontal.second();
 
-        quads.emplace_back(
+        target.emplace_back(
             rect.left() + horizontal.first(),
             rect.right() - horizontal.second(),
             rect.top() + vertical.first(),
@@ -482,14 +758,244 @@ namespace ms {
         );
     }
 
+    bool GraphicsGL::beginbatch() {
+        if (!batching || std::this_thread::get_id() != renderthread)
+            return false;
+
+        Batch& batch = batches[nextbatch];
+        batch.buffer = 0;
+        batch.generation = generation;
+        batch.lastused = frame;
+        batch.complete = false;
+
+        recording = true;
+
+        return true;
+    }
+
+    size_t GraphicsGL::endbatch() {
+        recording = false;
+
+        return nextbatch++;
+    }
+
+    bool GraphicsGL::drawbatch(size_t id, Point<int16_t> offset) {
+        if (locked)
+            return true;
+
+        auto iter = batches.find(id);
+
+        if (iter == batches.end())
+            return false;
+
+        Batch& batch = iter->second;
+
+        if (!batch.complete || batch.generation != generation)
+            buildbatch(batch);
+
+        // Keep the pages used by the batch from being evicted while it is on screen
+        for (size_t page : batch.pages)
+            pages[page].lastused = frame;
+
+        batch.lastused = frame;
+        batchdraws.push_back({id, quads.size(), offset});
+
+        return true;
+    }
+
+    void GraphicsGL::buildbatch(Batch& batch) {
+        std::vector<Quad> vertices;
+        uint64_t built = generation;
+
+        batch.chunks.clear();
+        batch.pages.clear();
+        batch.complete = true;
+
+        for (const Batch::Sprite& sprite : batch.sprites) {
+            const Offset* resident = findoffset(sprite.bitmap.id());
+
+            if (!resident) {
+                // Leave out bitmaps which are still being decoded and build the batch again later
+                if (decoder.is_running()) {
+                    addbitmap(sprite.bitmap);
+                    batch.complete = false;
+                    continue;
+                }
+
+                resident = &getoffset(sprite.bitmap);
+            }
+
+            if (resident != &nulloffset) {
+                size_t page = pageof(*resident);
+
+                if (std::find(batch.pages.begin(), batch.pages.end(), page) == batch.pages.end())
+                    batch.pages.push_back(page);
+            }
+
+            const Rectangle<int16_t>& rect = sprite.rect;
+
+            if (!batch.chunks.empty()) {
+                Batch::Chunk& chunk = batch.chunks.back();
+                const Rectangle<int16_t>& bounds = chunk.bounds;
+
+                auto merged = Rectangle<int16_t>(
+                    std::min(bounds.left(), rect.left()),
+                    std::max(bounds.right(), rect.right()),
+                    std::min(bounds.top(), rect.top()),
+                    std::max(bounds.bottom(), rect.bottom())
+                );
+
+                if (chunk.count < CHUNKQUADS && merged.width() <= CHUNKSIZE && merged.height() <= CHUNKSIZE) {
+                    chunk.bounds = merged;
+                    chunk.count++;
+
+                    addquad(vertices, *resident, rect, sprite.vertical, sprite.horizontal, sprite.color, sprite.angle);
+                    continue;
+                }
+            }
+
+            batch.chunks.push_back({rect, vertices.size(), 1});
+
+            addquad(vertices, *resident, rect, sprite.vertical, sprite.horizontal, sprite.color, sprite.angle);
+        }
+
+        // Bitmaps evicted while building invalidate the earlier quads
+        if (generation != built)
+            batch.complete = false;
+
+        batch.generation = generation;
+
+        if (indexed)
+            reserveindices(vertices.size());
+
+        if (!batch.buffer)
+            glGenBuffers(1, &batch.buffer);
+
+        glBindBuffer(GL_ARRAY_BUFFER, batch.buffer);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Quad), vertices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void GraphicsGL::drawchunks(Batch& batch, Point<int16_t> offset) {
+        if (batch.generation != generation)
+            buildbatch(batch);
+
+        batch.lastused = frame;
+
+        bindvertices(batch.buffer);
+        glUniform2f(uniform_viewoffset, offset.x(), offset.y());
+
+        // Chunks are drawn in the order they were recorded, neighbouring visible chunks are drawn together
+        size_t first = 0;
+        size_t count = 0;
+
+        for (const Batch::Chunk& chunk : batch.chunks) {
+            Rectangle<int16_t> bounds = chunk.bounds;
+            bounds.shift(offset);
+
+            if (!bounds.overlaps(SCREEN))
+                continue;
+
+            if (count > 0 && first + count == chunk.first) {
+                count += chunk.count;
+            } else {
+                drawquads(first, count);
+
+                first = chunk.first;
+                count = chunk.count;
+            }
+        }
+
+        drawquads(first, count);
+
+        glUniform2f(uniform_viewoffset, 0.0f, 0.0f);
+        bindvertices(VBO);
+    }
+
+    void GraphicsGL::reserveindices(size_t count) {
+        if (count <= indexcapacity)
+            return;
+
+        indexcapacity = std::max(count, indexcapacity * 2);
+
+        // Every quad is split into the triangles (top left, bottom left, bottom right) and (top left, bottom right, top right)
+        std::vector<GLuint> indices;
+        indices.reserve(indexcapacity * Quad::INDICES);
+
+        for (size_t i = 0; i < indexcapacity; i++) {
+            auto vertex = static_cast<GLuint>(i * Quad::LENGTH);
+
+            indices.insert(indices.end(), {vertex, vertex + 1, vertex + 2, vertex, vertex + 2, vertex + 3});
+        }
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+    }
+
+    void GraphicsGL::drawquads(size_t first, size_t count) {
+        if (count == 0)
+            return;
+
+        if (indexed) {
+            auto offset = reinterpret_cast<const void*>(first * Quad::INDICES * sizeof(GLuint));
+
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(count * Quad::INDICES), GL_UNSIGNED_INT, offset);
+        } else {
+            glDrawArrays(GL_QUADS, static_cast<GLint>(first * Quad::LENGTH), static_cast<GLsizei>(count * Quad::LENGTH));
+        }
+    }
+
+    void GraphicsGL::collectbatches() {
+        for (auto iter = batches.begin(); iter != batches.end();) {
+            Batch& batch = iter->second;
+
+            if (batch.lastused + BATCHLIFETIME < frame) {
+                if (batch.buffer)
+                    glDeleteBuffers(1, &batch.buffer);
+
+                iter = batches.erase(iter);
+            } else {
+                iter++;
+            }
+        }
+    }
+
     Text::Layout GraphicsGL::createlayout(const std::string& text, Text::Font id, Text::Alignment alignment,
                                           Color::Name color, int16_t maxwidth, bool formatted, int16_t line_adj) {
-        size_t length = text.length();
-
-        if (length == 0)
+        if (text.empty())
             return Text::Layout();
 
-        LayoutBuilder builder(id, fonts[id], alignment, color, maxwidth, formatted, line_adj);
+        // Layouts created by loading threads are not cached
+        if (std::this_thread::get_id() != renderthread)
+            return buildlayout(text, id, alignment, color, maxwidth, formatted, line_adj);
+
+        LayoutKey key = {text, id, alignment, color, maxwidth, formatted, line_adj};
+        auto iter = layoutindex.find(key);
+
+        if (iter != layoutindex.end()) {
+            layouthits++;
+            layouts.splice(layouts.begin(), layouts, iter->second);
+
+            return iter->second->second;
+        }
+
+        layoutmisses++;
+        layouts.emplace_front(key, buildlayout(text, id, alignment, color, maxwidth, formatted, line_adj));
+        layoutindex.emplace(std::move(key), layouts.begin());
+
+        if (layouts.size() > LAYOUTCACHESIZE) {
+            layoutindex.erase(layouts.back().first);
+            layouts.pop_back();
+        }
+
+        return layouts.front().second;
+    }
+
+    Text::Layout GraphicsGL::buildlayout(const std::string& text, Text::Font id, Text::Alignment alignment,
+                                         Color::Name color, int16_t maxwidth, bool formatted, int16_t line_adj) {
+        size_t length = text.length();
+
+        LayoutBuilder builder(*this, id, fonts[id], alignment, color, maxwidth, formatted, line_adj);
 
         const char* p_text = text.c_str();
 
@@ -509,9 +1015,10 @@ namespace ms {
         return builder.finish(first, offset);
     }
 
-    GraphicsGL::LayoutBuilder::LayoutBuilder(Text::Font id, const Font& f, Text::Alignment a, Color::Name c, int16_t mw,
-                                             bool fm, int16_t la) : font(f), alignment(a), fontid(id), color(c),
-                                                                    maxwidth(mw), formatted(fm), line_adj(la) {
+    GraphicsGL::LayoutBuilder::LayoutBuilder(GraphicsGL& g, Text::Font id, const Font& f, Text::Alignment a,
+                                             Color::Name c, int16_t mw, bool fm, int16_t la) :
+        graphics(g), font(f), baseid(id), alignment(a), fontid(id), color(c), maxwidth(mw), formatted(fm),
+        line_adj(la) {
         ax = 0;
         ay = font.linespace();
         width = 0;
@@ -784,12 +1291,19 @@ namespace ms {
                 if (c == '\t')
                     wordwidth += ax;
                 else
-                    wordwidth += font.chars[c].ax;
+                    wordwidth += graphics.advance(baseid, text, i, last);
 
                 if (wordwidth > maxwidth) {
-                    if (last - first == 1) {
-                        return last;
+                    // Keep at least one whole character on each line
+                    if (i == first) {
+                        do {
+                            i++;
+                        } while (i < last && (text[i] & 0xC0) == 0x80);
+
+                        if (i == last)
+                            return last;
                     }
+
                     prev = add(text, prev, first, i);
                     return add(text, prev, i, last);
                 }
@@ -815,14 +1329,13 @@ namespace ms {
 
         for (size_t pos = first; pos < last; pos++) {
             char c = text[pos];
-            const Font::Char& ch = font.chars[c];
 
             advances.push_back(ax);
 
             if (pos < first + skip || newline && c == ' ')
                 continue;
 
-            ax += ch.ax;
+            ax += graphics.advance(baseid, text, pos, last);
 
             if (width < ax)
                 width = ax;
@@ -921,8 +1434,13 @@ namespace ms {
 
                 for (size_t pos = word.first; pos < word.last; ++pos) {
                     const char c = text[pos];
-                    const Font& word_font = fonts[word.font];
-                    const Font::Char& ch = word_font.chars[c];
+                    uint32_t cp = codepoint(text.c_str(), pos, word.last);
+
+                    // Continuation bytes belong to the character before them
+                    if (cp == 0)
+                        continue;
+
+                    Font::Char ch = getglyph(word.font, cp, true);
 
                     GLshort char_x = x + ax + ch.bl;
                     GLshort char_y = y + ay - ch.bt;
@@ -951,7 +1469,8 @@ namespace ms {
 
                     ax += ch.ax;
 
-                    if (char_width <= 0 || char_height <= 0)
+                    // A glyph without offset did not fit into the atlas in this frame
+                    if (char_width <= 0 || char_height <= 0 || ch.offset.bottom == 0)
                         continue;
 
                     quads.emplace_back(char_x, char_x + char_width, char_y, char_bottom, offset, abscolor, 0.0f);
@@ -981,6 +1500,8 @@ namespace ms {
     }
 
     void GraphicsGL::flush(float opacity) {
+        PROFILE_SCOPE("GraphicsGL::flush");
+
         bool coverscene = opacity != 1.0f;
 
         if (coverscene) {
@@ -993,26 +1514,60 @@ namespace ms {
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        GLsizeiptr csize = quads.size() * sizeof(Quad);
-        GLsizeiptr fsize = quads.size() * Quad::LENGTH;
+        size_t quadcount = quads.size();
+        auto csize = static_cast<GLsizeiptr>(quadcount * sizeof(Quad));
 
         glEnableVertexAttribArray(attribute_coord);
         glEnableVertexAttribArray(attribute_color);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, csize, quads.data(), GL_STREAM_DRAW);
+        bindvertices(VBO);
+
+        // Orphan the storage of the last frame so the driver does not have to wait until it was drawn
+        if (csize > vbosize)
+            vbosize = std::max(csize, vbosize * 2);
+
+        glBufferData(GL_ARRAY_BUFFER, vbosize, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, csize, quads.data());
+
+        if (indexed) {
+            reserveindices(quadcount);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+        }
+
+        // Batches are drawn in between the quads which were added before and after them
+        size_t drawn = 0;
 
-        glDrawArrays(GL_QUADS, 0, fsize);
+        for (const BatchDraw& batchdraw : batchdraws) {
+            drawquads(drawn, batchdraw.quadindex - drawn);
+            drawn = batchdraw.quadindex;
+
+            auto iter = batches.find(batchdraw.batch);
+
+            if (iter != batches.end())
+                drawchunks(iter->second, batchdraw.offset);
+        }
+
+        drawquads(drawn, quadcount - drawn);
 
         glDisableVertexAttribArray(attribute_coord);
         glDisableVertexAttribArray(attribute_color);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+        if (indexed)
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
         if (coverscene)
             quads.pop_back();
+
+        uploadpending();
+        collectbatches();
+
+        frame++;
     }
 
     void GraphicsGL::clearscene() {
-        if (!locked)
+        if (!locked) {
             quads.clear();
+            batchdraws.clear();
+        }
     }
 }
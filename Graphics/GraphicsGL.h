@@ -17,16 +17,23 @@
 //////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include "AtlasPacker.h"
+#include "BitmapDecoder.h"
 #include "Text.h"
 
 #include "../Constants.h"
 #include "../Error.h"
 
-#include "../Util/QuadTree.h"
-
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include <algorithm>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
 #ifdef USE_NX
 #include <nlnx/bitmap.hpp>
 #endif
@@ -45,12 +52,42 @@ namespace ms {
         // Clear all bitmaps if most of the space is used up
         void clear();
 
+        // Usage counters of the texture atlas, in bytes
+        struct AtlasStats {
+            size_t used;
+            size_t wasted;
+            size_t evicted;
+            size_t evictions;
+            size_t inserts;
+            int64_t insert_time;
+            size_t pending;
+            size_t glyphs;
+            size_t glyph_evictions;
+            size_t layout_hits;
+            size_t layout_misses;
+        };
+
+        // Return the current usage counters of the texture atlas
+        AtlasStats get_atlas_stats() const;
+
         // Add a bitmap to the available resources
+        // If textures are decoded asynchronously the bitmap becomes available in a later frame
+        // Calls from threads other than the one which called 'init()' are ignored
         void addbitmap(const nl::bitmap& bmp);
         // Draw the bitmap with the given parameters
         void draw(const nl::bitmap& bmp, const Rectangle<int16_t>& rect, const Range<int16_t>& vertical,
                   const Range<int16_t>& horizontal, const Color& color, float angle);
 
+        // Start recording static bitmaps into a batch which is kept in its own vertex buffer
+        // While recording, 'draw' adds bitmaps to the batch instead of the scene
+        // Returns false if static batches are disabled, in which case nothing is recorded
+        bool beginbatch();
+        // Finish recording and return the id of the new batch
+        size_t endbatch();
+        // Draw a recorded batch shifted by the specified offset
+        // Returns false if the batch does not exist or was discarded and must be recorded again
+        bool drawbatch(size_t id, Point<int16_t> offset);
+
         // Create a layout for the text with the parameters specified
         Text::Layout createlayout(const std::string& text, Text::Font font, Text::Alignment alignment,
                                   Color::Name color, int16_t maxwidth, bool formatted, int16_t line_adj);
@@ -76,7 +113,11 @@ namespace ms {
 
     private:
         void clearinternal();
+        void clearpage(size_t page);
+        void evictpage(size_t page);
         bool addfont(const char* name, Text::Font id, FT_UInt width, FT_UInt height);
+        Text::Layout buildlayout(const std::string& text, Text::Font font, Text::Alignment alignment,
+                                 Color::Name color, int16_t maxwidth, bool formatted, int16_t line_adj);
 
         struct Offset {
             GLshort left;
@@ -99,38 +140,25 @@ namespace ms {
             }
         };
 
+        // Return the location of a resident bitmap, or nullptr if it is not in the atlas
+        const Offset* findoffset(size_t id);
         // Add a bitmap to the available resources
         const Offset& getoffset(const nl::bitmap& bmp);
+        // Copy decoded pixels into the atlas
+        const Offset& upload(size_t id, GLshort width, GLshort height, const void* pixels);
+        // Upload bitmaps decoded by the worker thread, up to the per-frame budget
+        void uploadpending();
 
-        struct Leftover {
-            GLshort left;
-            GLshort right;
+        // A fixed-size horizontal band of the atlas with its own packing state
+        struct Page {
             GLshort top;
-            GLshort bottom;
-
-            Leftover(GLshort x, GLshort y, GLshort width, GLshort height) {
-                left = x;
-                right = x + width;
-                top = y;
-                bottom = y + height;
-            }
-
-            Leftover() {
-                left = 0;
-                right = 0;
-                top = 0;
-                bottom = 0;
-            }
-
-            GLshort width() const {
-                return right - left;
-            }
-
-            GLshort height() const {
-                return bottom - top;
-            }
+            std::unique_ptr<AtlasPacker> packer;
+            std::vector<size_t> bitmaps;
+            uint64_t lastused;
         };
 
+        size_t pageof(const Offset& offset) const;
+
         struct Quad {
             struct Vertex {
                 // Local Space Position
@@ -141,18 +169,27 @@ namespace ms {
                 GLshort texcoord_x;
                 GLshort texcoord_y;
 
-                Color color;
+                // Color components scaled to [0, 255]
+                GLubyte color[Color::LENGTH];
             };
 
             static constexpr size_t LENGTH = 4;
+            static constexpr size_t INDICES = 6;
             Vertex vertices[LENGTH];
 
             Quad(GLshort left, GLshort right, GLshort top, GLshort bottom, const Offset& offset, const Color& color,
                  GLfloat rotation) {
-                vertices[0] = {left, top, offset.left, offset.top, color};
-                vertices[1] = {left, bottom, offset.left, offset.bottom, color};
-                vertices[2] = {right, bottom, offset.right, offset.bottom, color};
-                vertices[3] = {right, top, offset.right, offset.top, color};
+                GLubyte packed[Color::LENGTH];
+
+                for (size_t i = 0; i < Color::LENGTH; i++) {
+                    GLfloat component = std::min(std::max(color.data()[i], 0.0f), 1.0f);
+                    packed[i] = static_cast<GLubyte>(component * 255.0f + 0.5f);
+                }
+
+                vertices[0] = {left, top, offset.left, offset.top, {packed[0], packed[1], packed[2], packed[3]}};
+                vertices[1] = {left, bottom, offset.left, offset.bottom, {packed[0], packed[1], packed[2], packed[3]}};
+                vertices[2] = {right, bottom, offset.right, offset.bottom, {packed[0], packed[1], packed[2], packed[3]}};
+                vertices[3] = {right, top, offset.right, offset.top, {packed[0], packed[1], packed[2], packed[3]}};
 
                 if (rotation != 0.0f) {
                     GLfloat cos = std::cos(rotation);
@@ -172,6 +209,59 @@ namespace ms {
             }
         };
 
+        // Add a quad showing the part of a resident bitmap which is not cut off by the ranges
+        void addquad(std::vector<Quad>& target, Offset offset, const Rectangle<int16_t>& rect,
+                     const Range<int16_t>& vertical, const Range<int16_t>& horizontal, const Color& color,
+                     float angle);
+
+        // A group of static bitmaps kept in its own vertex buffer
+        // The quads are split into chunks of nearby quads so that offscreen chunks can be skipped
+        struct Batch {
+            struct Sprite {
+                nl::bitmap bitmap;
+                Rectangle<int16_t> rect;
+                Range<int16_t> vertical;
+                Range<int16_t> horizontal;
+                Color color;
+                float angle;
+            };
+
+            // A range of quads in the vertex buffer
+            struct Chunk {
+                Rectangle<int16_t> bounds;
+                size_t first;
+                size_t count;
+            };
+
+            std::vector<Sprite> sprites;
+            std::vector<Chunk> chunks;
+            std::vector<size_t> pages;
+            GLuint buffer;
+            uint64_t generation;
+            uint64_t lastused;
+            bool complete;
+        };
+
+        // A batch drawn after the first 'quadindex' quads of the scene
+        struct BatchDraw {
+            size_t batch;
+            size_t quadindex;
+            Point<int16_t> offset;
+        };
+
+        // Build the vertex buffer of a batch from the bitmaps currently in the atlas
+        void buildbatch(Batch& batch);
+        // Draw the chunks of a batch which are on the screen
+        void drawchunks(Batch& batch, Point<int16_t> offset);
+        // Make sure the index buffer covers at least the specified number of quads
+        void reserveindices(size_t count);
+        // Draw a range of quads from the bound vertex buffer
+        void drawquads(size_t first, size_t count);
+        // Delete batches which have not been drawn for a while
+        void collectbatches();
+        // Bind a vertex buffer and point the shader attributes at it
+        void bindvertices(GLuint buffer);
+
         struct Font {
             struct Char {
                 GLshort ax;
@@ -202,10 +292,65 @@ namespace ms {
             }
         };
 
+        // A character outside of ASCII, rasterized on first use
+        // The bitmap is only kept in the glyph region of the atlas while there is space for it
+        struct Glyph {
+            Font::Char metrics;
+            size_t cell;
+        };
+
+        // A fixed-size slot in the glyph region of the atlas
+        struct GlyphCell {
+            uint64_t key;
+            uint64_t lastused;
+            std::list<size_t>::iterator position;
+        };
+
+        // Decode the UTF-8 sequence starting at 'pos', returns zero for continuation bytes
+        static uint32_t codepoint(const char* text, size_t pos, size_t last);
+        // Return the metrics of a character, non-ASCII characters are rasterized on demand
+        // If 'resident' is set the glyph is also placed into the atlas, unless all cells were used in this frame
+        // A glyph which could not be placed has an empty offset
+        Font::Char getglyph(Text::Font id, uint32_t codepoint, bool resident);
+        // Return the horizontal advance of the character starting at 'pos'
+        int16_t advance(Text::Font id, const char* text, size_t pos, size_t last);
+        // Copy a rendered glyph into a cell of the atlas, evicting the least recently used glyph if needed
+        bool placeglyph(uint64_t key, Glyph& glyph, const FT_Bitmap& bitmap);
+
+        // The parameters which determine the layout of a text
+        struct LayoutKey {
+            std::string text;
+            Text::Font font;
+            Text::Alignment alignment;
+            Color::Name color;
+            int16_t maxwidth;
+            bool formatted;
+            int16_t line_adj;
+
+            bool operator==(const LayoutKey& other) const {
+                return text == other.text && font == other.font && alignment == other.alignment &&
+                       color == other.color && maxwidth == other.maxwidth && formatted == other.formatted &&
+                       line_adj == other.line_adj;
+            }
+        };
+
+        struct LayoutKeyHash {
+            size_t operator()(const LayoutKey& key) const {
+                size_t hash = std::hash<std::string>()(key.text);
+                size_t params = static_cast<uint16_t>(key.maxwidth) << 16 | key.color << 8 | key.font << 2 |
+                                key.alignment;
+                params = params * 31 + static_cast<uint16_t>(key.line_adj) * 2 + key.formatted;
+
+                return hash ^ (params + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+            }
+        };
+
+        using LayoutEntry = std::pair<LayoutKey, Text::Layout>;
+
         class LayoutBuilder {
         public:
-            LayoutBuilder(Text::Font id, const Font& font, Text::Alignment alignment, Color::Name color,
-                          int16_t maxwidth, bool formatted, int16_t line_adj);
+            LayoutBuilder(GraphicsGL& graphics, Text::Font id, const Font& font, Text::Alignment alignment,
+                          Color::Name color, int16_t maxwidth, bool formatted, int16_t line_adj);
 
             size_t add(const char* text, size_t prev, size_t first, size_t last);
             Text::Layout finish(size_t first, size_t last);
@@ -214,7 +359,9 @@ namespace ms {
             void add_word(size_t first, size_t last, Text::Font font, Color::Name color);
             void add_line();
 
+            GraphicsGL& graphics;
             const Font& font;
+            Text::Font baseid;
 
             Text::Alignment alignment;
             Text::Font fontid;
@@ -239,12 +386,29 @@ namespace ms {
 
         static constexpr GLshort ATLASW = 8192;
         static constexpr GLshort ATLASH = 8192;
-        static constexpr GLshort MINLOSIZE = 32;
+        static constexpr size_t NUMPAGES = 4;
+        static constexpr double CLEARFILL = 0.8;
+        static constexpr size_t NUMPBOS = 4;
+        static constexpr size_t UPLOADBUDGET = 4 * 1024 * 1024;
+        static constexpr size_t BYTESPERPIXEL = 4;
+        static constexpr int16_t CHUNKSIZE = 512;
+        static constexpr size_t CHUNKQUADS = 256;
+        static constexpr uint64_t BATCHLIFETIME = 600;
+        static constexpr GLshort GLYPHCELL = 32;
+        static constexpr GLshort GLYPHROWS = 8;
+        static constexpr size_t NUMGLYPHCELLS = (ATLASW / GLYPHCELL) * GLYPHROWS;
+        static constexpr size_t NOCELL = SIZE_MAX;
+        static constexpr size_t LAYOUTCACHESIZE = 1024;
 
         bool locked;
+        std::thread::id renderthread;
 
         std::vector<Quad> quads;
         GLuint VBO;
+        GLsizeiptr vbosize;
+        GLuint IBO;
+        size_t indexcapacity;
+        bool indexed;
         GLuint atlas;
 
         GLint shaderProgram;
@@ -253,21 +417,52 @@ namespace ms {
         GLint uniform_texture;
         GLint uniform_atlassize;
         GLint uniform_screensize;
-        GLint uniform_yoffset;
+        GLint uniform_viewoffset;
         GLint uniform_fontregion;
 
         std::unordered_map<size_t, Offset> offsets;
+        std::unordered_set<size_t> pending;
+        BitmapDecoder decoder;
+        GLuint pbos[NUMPBOS];
+        size_t pboindex;
         Offset nulloffset;
 
-        QuadTree<size_t, Leftover> leftovers;
-        size_t rlid;
-        size_t wasted;
-        Point<GLshort> border;
-        Range<GLshort> yrange;
+        Page pages[NUMPAGES];
+        GLshort pageheight;
+        // Bitmap sizes and map changes, see 'AtlasTrace'
+        std::ofstream atlastrace;
+        uint64_t frame;
+        size_t evicted;
+        size_t evictions;
+        // Incremented whenever bitmaps are removed from the atlas
+        uint64_t generation;
+
+        bool batching;
+        bool recording;
+        size_t nextbatch;
+        std::unordered_map<size_t, Batch> batches;
+        std::vector<BatchDraw> batchdraws;
 
         FT_Library ftlibrary;
+        FT_Face faces[Text::Font::NUM_FONTS];
         Font fonts[Text::Font::NUM_FONTS];
         Point<GLshort> fontborder;
         GLshort fontymax;
+
+        // Characters outside of ASCII, keyed by font and code point
+        // Layouts may be created by loading threads, so access to the glyphs and faces is locked
+        std::mutex glyphlock;
+        std::unordered_map<uint64_t, Glyph> glyphs;
+        std::vector<GlyphCell> glyphcells;
+        // Cells of the glyph region ordered from most to least recently used
+        std::list<size_t> glyphlru;
+        GLshort glyphtop;
+        size_t glyphevictions;
+
+        // Recently created layouts ordered from most to least recently used
+        std::list<LayoutEntry> layouts;
+        std::unordered_map<LayoutKey, std::list<LayoutEntry>::iterator, LayoutKeyHash> layoutindex;
+        size_t layouthits;
+        size_t layoutmisses;
     };
 }
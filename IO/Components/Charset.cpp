@@ -18,10 +18,23 @@
 #include "Charset.h"
 
 namespace ms {
+    Charset::Run::Run() : length(0), shift(0) {
+    }
+
+    int16_t Charset::Run::get_shift() const {
+        return shift;
+    }
+
     Charset::Charset() : Charset({}, LEFT) {
     }
 
     Charset::Charset(nl::node src, Alignment alignment) : alignment(alignment) {
+        slots.fill(0);
+        widths.fill(0);
+
+        // Slot zero is the empty texture for missing characters
+        textures.emplace_back();
+
         for (nl::node node : src) {
             std::string name = node.name();
 
@@ -33,28 +46,45 @@ namespace ms {
             if (c == '\\')
                 c = '/';
 
-            chars.emplace(c, node);
+            auto index = static_cast<uint8_t>(c);
+
+            if (slots[index] != 0 || textures.size() == NUM_CHARS)
+                continue;
+
+            slots[index] = static_cast<uint8_t>(textures.size());
+            textures.emplace_back(node);
+            widths[index] = textures.back().width();
         }
     }
 
     void Charset::draw(int8_t c, const DrawArgument& args) const {
-        auto iter = chars.find(c);
+        uint8_t slot = slots[static_cast<uint8_t>(c)];
 
-        if (iter != chars.end())
-            iter->second.draw(args);
+        if (slot != 0)
+            textures[slot].draw(args);
     }
 
     int16_t Charset::getw(int8_t c) const {
-        auto iter = chars.find(c);
+        return widths[static_cast<uint8_t>(c)];
+    }
 
-        if (iter != chars.end())
-            return iter->second.width();
+    int16_t Charset::draw(const std::string& text, const DrawArgument& args) const {
+        Run run = layout(text);
+        draw(run, args);
 
-        return 0;
+        return run.get_shift();
     }
 
-    // TODO: The two below draw methods need combined adding hspace to width only if it does not equal zero
-    int16_t Charset::draw(const std::string& text, const DrawArgument& args) const {
+    int16_t Charset::draw(const std::string& text, int16_t hspace, const DrawArgument& args) const {
+        Run run = layout(text, hspace);
+        draw(run, args);
+
+        return run.get_shift();
+    }
+
+    // TODO: The two below layout methods need combined adding hspace to width only if it does not equal zero
+    Charset::Run Charset::layout(const std::string& text) const {
+        Run run;
         int16_t shift = 0;
         int16_t total = 0;
 
@@ -63,7 +93,7 @@ namespace ms {
             for (char c : text) {
                 int16_t width = getw(c);
 
-                draw(c, args + Point<int16_t>(shift, 0));
+                append(run, c, {shift, 0});
 
                 shift += width + 2;
                 total += width;
@@ -74,7 +104,7 @@ namespace ms {
         }
         case LEFT: {
             for (char c : text) {
-                draw(c, args + Point<int16_t>(shift, 0));
+                append(run, c, {shift, 0});
 
                 shift += getw(c) + 1;
             }
@@ -86,17 +116,20 @@ namespace ms {
                 char c = *iter;
                 shift += getw(c);
 
-                draw(c, args - Point<int16_t>(shift, 0));
+                append(run, c, {static_cast<int16_t>(-shift), 0});
             }
 
             break;
         }
         }
 
-        return shift;
+        run.shift = shift;
+
+        return run;
     }
 
-    int16_t Charset::draw(const std::string& text, int16_t hspace, const DrawArgument& args) const {
+    Charset::Run Charset::layout(const std::string& text, int16_t hspace) const {
+        Run run;
         size_t length = text.size();
         int16_t shift = 0;
 
@@ -107,7 +140,7 @@ namespace ms {
         }
         case LEFT: {
             for (char c : text) {
-                draw(c, args + Point<int16_t>(shift, 0));
+                append(run, c, {shift, 0});
 
                 shift += hspace;
             }
@@ -120,13 +153,32 @@ namespace ms {
 
                 shift += hspace;
 
-                draw(c, args - Point<int16_t>(shift, 0));
+                append(run, c, {static_cast<int16_t>(-shift), 0});
             }
 
             break;
         }
         }
 
-        return shift;
+        run.shift = shift;
+
+        return run;
+    }
+
+    void Charset::append(Run& run, int8_t c, Point<int16_t> offset) const {
+        uint8_t slot = slots[static_cast<uint8_t>(c)];
+
+        if (slot == 0 || run.length == Run::MAXLENGTH)
+            return;
+
+        run.glyphs[run.length] = {slot, offset};
+        run.length++;
+    }
+
+    void Charset::draw(const Run& run, const DrawArgument& args) const {
+        for (uint8_t i = 0; i < run.length; i++) {
+            const Run::Glyph& glyph = run.glyphs[i];
+            textures[glyph.slot].draw(args + glyph.offset);
+        }
     }
 }
@@ -19,7 +19,8 @@
 
 #include "../../Graphics/Texture.h"
 
-#include <unordered_map>
+#include <array>
+#include <vector>
 
 namespace ms {
     class Charset {
@@ -30,6 +31,30 @@ namespace ms {
             RIGHT
         };
 
+        // Characters with their positions computed in advance, so drawing needs no lookups
+        // A run can only be drawn by the charset which created it
+        class Run {
+        public:
+            static constexpr size_t MAXLENGTH = 32;
+
+            Run();
+
+            // Return the value 'draw' returns for the text of this run
+            int16_t get_shift() const;
+
+        private:
+            friend Charset;
+
+            struct Glyph {
+                uint8_t slot;
+                Point<int16_t> offset;
+            };
+
+            std::array<Glyph, MAXLENGTH> glyphs;
+            uint8_t length;
+            int16_t shift;
+        };
+
         Charset();
         Charset(nl::node source, Alignment alignment);
 
@@ -38,8 +63,21 @@ namespace ms {
         int16_t draw(const std::string& text, int16_t hspace, const DrawArgument& args) const;
         int16_t getw(int8_t character) const;
 
+        // Lay out a text in the same way as the draw methods
+        Run layout(const std::string& text) const;
+        Run layout(const std::string& text, int16_t hspace) const;
+        // Add a character to a run, characters beyond the maximum length are ignored
+        void append(Run& run, int8_t character, Point<int16_t> offset) const;
+        // Draw all characters of a run
+        void draw(const Run& run, const DrawArgument& args) const;
+
     private:
-        std::unordered_map<int8_t, Texture> chars;
+        static constexpr size_t NUM_CHARS = 256;
+
+        // Index into 'textures' for each character, zero for characters without a texture
+        std::array<uint8_t, NUM_CHARS> slots;
+        std::array<int16_t, NUM_CHARS> widths;
+        std::vector<Texture> textures;
         Alignment alignment;
     };
 }
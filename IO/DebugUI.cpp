@@ -1,6 +1,11 @@
 #include "DebugUI.h"
 
+#include "../Configuration.h"
 #include "../Gameplay/Stage.h"
+#include "../Graphics/GraphicsGL.h"
+#include "../Net/PacketRecorder.h"
+#include "../Net/Session.h"
+#include "../Util/Profiler.h"
 
 #include <GLFW/glfw3.h>
 #include <sstream>
@@ -20,6 +25,7 @@ namespace ms {
     }
 
     void DebugUI::init() {
+        Profiler::get().set_enabled(Setting<Profiling>::get().load());
     }
 
     bool DebugUI::is_shown() const {
@@ -223,6 +229,105 @@ namespace ms {
                         1, 64, "%d", ImGuiSliderFlags_AlwaysClamp & ImGuiSliderFlags_Logarithmic);
                     }
 
+                    ImGui::SetNextItemOpen(true, ImGuiCond_Appearing);
+                    if (ImGui::CollapsingHeader("Atlas")) {
+                        GraphicsGL::AtlasStats stats = GraphicsGL::get().get_atlas_stats();
+
+                        ImGui::Text("Used: %zu KB", stats.used / 1024);
+                        ImGui::Text("Wasted: %zu KB", stats.wasted / 1024);
+                        ImGui::Text("Evicted: %zu KB (%zu pages)", stats.evicted / 1024, stats.evictions);
+                        ImGui::Text("Pending: %zu", stats.pending);
+
+                        if (stats.inserts > 0)
+                            ImGui::Text("Insert: %lld ns", static_cast<long long>(stats.insert_time / static_cast<int64_t>(stats.inserts)));
+
+                        ImGui::Text("Glyphs: %zu (%zu evicted)", stats.glyphs, stats.glyph_evictions);
+                        ImGui::Text("Layouts: %zu hits, %zu misses", stats.layout_hits, stats.layout_misses);
+                    }
+
+                    if (ImGui::CollapsingHeader("Effects")) {
+                        Combat::DropStats dropped = Stage::get().get_combat().get_drop_stats();
+
+                        ImGui::Text("Dropped effects: %zu", EffectLayer::get_dropped());
+                        ImGui::Text("Dropped bullets: %zu", dropped.bullets);
+                        ImGui::Text("Dropped damage numbers: %zu", dropped.damagenumbers);
+                    }
+
+                    ImGui::SetNextItemOpen(true, ImGuiCond_Appearing);
+                    if (ImGui::CollapsingHeader("Network")) {
+                        Session::NetStats stats = Session::get().get_net_stats();
+
+                        ImGui::Text("Received: %zu bytes", stats.bytes);
+                        ImGui::Text("Packets: %zu", stats.packets);
+                        ImGui::Text("Backlog: %zu bytes", stats.backlog);
+                        ImGui::Text("Capturing: %s", PacketRecorder::get().is_recording() ? "TRUE" : "FALSE");
+
+                        const auto& opcodes = PacketRecorder::get().get_stats(PacketRecorder::Direction::INBOUND);
+
+                        if (ImGui::BeginTable("opcodes", 4, 0, { 0, 0 })) {
+                            ImGui::TableSetupColumn("Opcode", ImGuiTableColumnFlags_None, 0);
+                            ImGui::TableSetupColumn("Count", ImGuiTableColumnFlags_None, 0);
+                            ImGui::TableSetupColumn("Bytes", ImGuiTableColumnFlags_None, 0);
+                            ImGui::TableSetupColumn("Time (us)", ImGuiTableColumnFlags_None, 0);
+                            ImGui::TableHeadersRow();
+
+                            for (size_t opcode = 0; opcode < PacketRecorder::NUM_OPCODES; opcode++) {
+                                if (opcodes[opcode].count == 0)
+                                    continue;
+
+                                ImGui::TableNextRow(0, 0);
+                                ImGui::TableSetColumnIndex(0);
+                                ImGui::Text("0x%04zX", opcode);
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%zu", opcodes[opcode].count);
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%zu", opcodes[opcode].bytes);
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%.1f", opcodes[opcode].time / 1000.0);
+                            }
+
+                            ImGui::EndTable();
+                        }
+                    }
+
+                    ImGui::SetNextItemOpen(true, ImGuiCond_Appearing);
+                    if (ImGui::CollapsingHeader("Profiler")) {
+                        Profiler& profiler = Profiler::get();
+
+                        bool enabled = profiler.is_enabled();
+                        if (ImGui::Checkbox("Enabled", &enabled))
+                            profiler.set_enabled(enabled);
+
+                        ImGui::SameLine(0, 1 * ImGui::GetStyle().ItemSpacing.x);
+                        if (ImGui::Button("Export trace"))
+                            profiler.export_trace("trace.json");
+
+                        if (ImGui::BeginTable("profiler", 5, 0, { 0, 0 })) {
+                            ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_None, 0);
+                            ImGui::TableSetupColumn("p50 (us)", ImGuiTableColumnFlags_None, 0);
+                            ImGui::TableSetupColumn("p90 (us)", ImGuiTableColumnFlags_None, 0);
+                            ImGui::TableSetupColumn("p99 (us)", ImGuiTableColumnFlags_None, 0);
+                            ImGui::TableSetupColumn("Max (us)", ImGuiTableColumnFlags_None, 0);
+                            ImGui::TableHeadersRow();
+
+                            for (const Profiler::Summary& summary : profiler.summarize()) {
+                                ImGui::TableNextRow(0, 0);
+                                ImGui::TableSetColumnIndex(0);
+                                ImGui::TextUnformatted(summary.name);
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%.1f", summary.p50 / 1000.0);
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%.1f", summary.p90 / 1000.0);
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%.1f", summary.p99 / 1000.0);
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%.1f", summary.max / 1000.0);
+                            }
+
+                            ImGui::EndTable();
+                        }
+                    }
+
                     ImGui::EndTabItem();
                 }
 
@@ -33,6 +33,8 @@
 #include "UITypes/UIStatusBar.h"
 #include "UITypes/UIWorldMap.h"
 
+#include "../Util/Profiler.h"
+
 namespace ms {
     UI::UI() {
         state = std::make_unique<UIStateNull>();
@@ -48,6 +50,8 @@ namespace ms {
     }
 
     void UI::draw(float alpha) const {
+        PROFILE_SCOPE("UI::draw");
+
         state->draw(alpha, cursor.get_position());
 
         scrollingnotice.draw(alpha);
@@ -56,6 +60,8 @@ namespace ms {
     }
 
     void UI::update() {
+        PROFILE_SCOPE("UI::update");
+
         state->update();
 
         scrollingnotice.update();
@@ -29,7 +29,13 @@
 
 namespace ms {
     UIChatBar::UIChatBar() : temp_view_x(0), temp_view_y(0), view_input(false), view_adjusted(false),
-                             position_adjusted(false), drag_direction(NONE) {
+                             position_adjusted(false), drag_direction(NONE),
+                             message_history(std::max<uint16_t>(Setting<ChatLogSize>::get().load(), 1)) {
+        std::string transcript_path = Setting<ChatTranscript>::get().load();
+
+        if (!transcript_path.empty())
+            transcript.open(transcript_path, std::ios::app);
+
         nl::node ingame = nl::nx::UI["StatusBar3.img"]["chat"]["ingame"];
         nl::node input = ingame["input"];
 
@@ -179,15 +185,14 @@ namespace ms {
 
             drag.draw(position - Point<int16_t>(0, top_y + center_y + user_view_y));
 
-            int16_t message_y = 0;
+            size_t size = message_history.size();
+            size_t rows = std::min(visible_rows(), size);
 
-            for (int i = message_history.size() - 1; i >= 0; i--) {
-                if (message_y <= center_y + user_view_y) {
-                    message_history[i].text.draw(
-                        position - Point<int16_t>(drag.get_origin().x() - 2, 5) - Point<int16_t>(0, message_y));
+            for (size_t i = 0; i < rows; i++) {
+                auto message_y = static_cast<int16_t>(i * MESSAGE_ROW_HEIGHT);
 
-                    message_y += 13;
-                }
+                message_history[size - 1 - i].text.draw(
+                    position - Point<int16_t>(drag.get_origin().x() - 2, 5) - Point<int16_t>(0, message_y));
             }
 
             if (view_input) {
@@ -288,10 +293,8 @@ namespace ms {
 
             drag.draw(position - Point<int16_t>(0, top_y + center_y));
 
-            const size_t size = message_history.size();
-
-            if (size > 0)
-                message_history[size - 1].text.draw(
+            if (!message_history.empty())
+                message_history.back().text.draw(
                     position - Point<int16_t>(0, top_y + center_y) + Point<int16_t>(
                         drag.get_origin().abs().x(), drag.height()) + Point<int16_t>(2, 7));
         }
@@ -315,6 +318,40 @@ namespace ms {
     void UIChatBar::update() {
         input_text.update(get_input_text_position(),
                           Point<int16_t>(input_max_x - (input_bg_x - user_view_x) - 22, INPUT_TEXT_HEIGHT));
+
+        update_messages();
+    }
+
+    size_t UIChatBar::visible_rows() const {
+        if (!view_max)
+            return 1;
+
+        return (center_y + user_view_y) / MESSAGE_ROW_HEIGHT + 1;
+    }
+
+    void UIChatBar::update_messages() {
+        size_t size = message_history.size();
+        size_t rows = std::min(visible_rows(), size);
+
+        for (size_t i = 0; i < rows; i++) {
+            Message& message = message_history[size - 1 - i];
+
+            if (!message.laidout) {
+                message.text = Text(Text::Font::A11M, Text::Alignment::LEFT, message.color, message.content);
+                message.laidout = true;
+            }
+        }
+
+        // The laid out messages are always the newest ones, so stop at the first message without a layout
+        for (size_t i = rows; i < size; i++) {
+            Message& message = message_history[size - 1 - i];
+
+            if (!message.laidout)
+                break;
+
+            message.text = Text();
+            message.laidout = false;
+        }
     }
 
     Button::State UIChatBar::button_pressed(uint16_t buttonid) {
@@ -811,7 +848,10 @@ namespace ms {
         else
             LOG(LOG_DEBUG, "[UIChatBar::show_message]: " << type << " not supported.");
 
-        message_history.emplace_back(ALL, type, Text(Text::Font::A11M, Text::Alignment::LEFT, color, message));
+        message_history.push_back(Message(ALL, type, color, message));
+
+        if (transcript.is_open())
+            transcript << message << std::endl;
     }
 
     bool UIChatBar::indragrange(Point<int16_t> cursor_position) const {
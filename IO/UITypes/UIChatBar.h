@@ -21,9 +21,13 @@
 
 #include "../Components/Textfield.h"
 
+#include "../../Template/RingBuffer.h"
+
 // TODO: Change these?
 #include "../Messages.h"
 
+#include <fstream>
+
 namespace ms {
     class UIChatBar : public UIDragElement<PosCHAT> {
     public:
@@ -74,6 +78,7 @@ namespace ms {
 
     private:
         static constexpr int16_t INPUT_TEXT_HEIGHT = 18;
+        static constexpr int16_t MESSAGE_ROW_HEIGHT = 13;
         static constexpr int16_t MIN_HEIGHT = 12;
         static constexpr int16_t MAX_HEIGHT = 467;
 
@@ -149,21 +154,28 @@ namespace ms {
         struct Message {
             MessageGroup group;
             MessageType type;
+            Color::Name color;
+            std::string content;
+            // Only messages which can be seen are laid out
             Text text;
+            bool laidout;
 
-            Message() : group(ALL), type(UNK0),
-                        text(Text::Font::A11M, Text::Alignment::LEFT, Color::Name::WHITE, "") {
+            Message() : group(ALL), type(UNK0), color(Color::Name::WHITE), laidout(false) {
             }
 
-            Message(std::string text) : group(ALL), type(UNK0),
-                                        text(Text::Font::A11M, Text::Alignment::LEFT, Color::Name::WHITE, text) {
-            }
-
-            Message(MessageGroup group, MessageType type, Text text) : group(group), type(type), text(text) {
+            Message(MessageGroup group, MessageType type, Color::Name color, std::string content) :
+                group(group), type(type), color(color), content(std::move(content)), laidout(false) {
             }
         };
 
-        std::vector<Message> message_history;
+        // Return the number of messages which fit into the current view
+        size_t visible_rows() const;
+        // Lay out the messages which can be seen and release the layouts of the others
+        void update_messages();
+
+        // The most recent messages, older ones are only kept in the transcript
+        RingBuffer<Message> message_history;
+        std::ofstream transcript;
         std::vector<std::string> user_message_history;
         size_t user_message_history_index;
 
@@ -58,6 +58,14 @@ namespace ms {
         character_active = false;
         event_active = false;
 
+        // Any stat value differs from these, so the first update lays out all readouts
+        readout_exp = -1;
+        readout_level = -1;
+        readout_hp = -1;
+        readout_mp = -1;
+        readout_maxhp = -1;
+        readout_maxmp = -1;
+
         std::string stat = "status";
 
         if (VWIDTH == 800)
@@ -375,34 +383,10 @@ namespace ms {
         hpmp_sprites[1].draw(position, alpha);
         hpmp_sprites[2].draw(position, alpha);
 
-        int16_t level = stats.get_stat(MapleStat::Id::LEVEL);
-        int16_t hp = stats.get_stat(MapleStat::Id::HP);
-        int16_t mp = stats.get_stat(MapleStat::Id::MP);
-        int32_t maxhp = stats.get_total(EquipStat::Id::HP);
-        int32_t maxmp = stats.get_total(EquipStat::Id::MP);
-        int64_t exp = stats.get_exp();
-
-        std::string expstring = std::to_string(100 * getexppercent());
-
-        statset.draw(
-            std::to_string(exp) + "[" + expstring.substr(0, expstring.find('.') + 3) + "%]",
-            position + statset_pos
-        );
-
-        hpmpset.draw(
-            "[" + std::to_string(hp) + "/" + std::to_string(maxhp) + "]",
-            position + hpset_pos
-        );
-
-        hpmpset.draw(
-            "[" + std::to_string(mp) + "/" + std::to_string(maxmp) + "]",
-            position + mpset_pos
-        );
-
-        levelset.draw(
-            std::to_string(level),
-            position + levelset_pos
-        );
+        statset.draw(exp_readout, position + statset_pos);
+        hpmpset.draw(hp_readout, position + hpset_pos);
+        hpmpset.draw(mp_readout, position + mpset_pos);
+        levelset.draw(level_readout, position + levelset_pos);
 
         namelabel.draw(position + namelabel_pos);
 
@@ -485,6 +469,8 @@ namespace ms {
         hpbar.update(gethppercent());
         mpbar.update(getmppercent());
 
+        update_readouts();
+
         namelabel.change_text(stats.get_name());
 
         Point<int16_t> pos_adj = get_quickslot_pos();
@@ -979,6 +965,39 @@ namespace ms {
         return menu_active || setting_active || community_active || character_active || event_active;
     }
 
+    void UIStatusBar::update_readouts() {
+        int16_t level = stats.get_stat(MapleStat::Id::LEVEL);
+        int16_t hp = stats.get_stat(MapleStat::Id::HP);
+        int16_t mp = stats.get_stat(MapleStat::Id::MP);
+        int32_t maxhp = stats.get_total(EquipStat::Id::HP);
+        int32_t maxmp = stats.get_total(EquipStat::Id::MP);
+        int64_t exp = stats.get_exp();
+
+        if (exp != readout_exp || level != readout_level) {
+            std::string expstring = std::to_string(100 * getexppercent());
+
+            exp_readout = statset.layout(
+                std::to_string(exp) + "[" + expstring.substr(0, expstring.find('.') + 3) + "%]"
+            );
+        }
+
+        if (hp != readout_hp || maxhp != readout_maxhp)
+            hp_readout = hpmpset.layout("[" + std::to_string(hp) + "/" + std::to_string(maxhp) + "]");
+
+        if (mp != readout_mp || maxmp != readout_maxmp)
+            mp_readout = hpmpset.layout("[" + std::to_string(mp) + "/" + std::to_string(maxmp) + "]");
+
+        if (level != readout_level)
+            level_readout = levelset.layout(std::to_string(level));
+
+        readout_exp = exp;
+        readout_level = level;
+        readout_hp = hp;
+        readout_mp = mp;
+        readout_maxhp = maxhp;
+        readout_maxmp = maxmp;
+    }
+
     float UIStatusBar::getexppercent() const {
         int16_t level = stats.get_stat(MapleStat::Id::LEVEL);
 
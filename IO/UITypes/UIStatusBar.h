@@ -65,6 +65,9 @@ namespace ms {
         float gethppercent() const;
         float getmppercent() const;
 
+        // Lay out the stat and level numbers again if any of them changed
+        void update_readouts();
+
         void toggle_qs(bool quick_slot_active);
         void toggle_setting();
         void toggle_community();
@@ -120,6 +123,16 @@ namespace ms {
         Charset statset;
         Charset hpmpset;
         Charset levelset;
+        Charset::Run exp_readout;
+        Charset::Run hp_readout;
+        Charset::Run mp_readout;
+        Charset::Run level_readout;
+        int64_t readout_exp;
+        int16_t readout_level;
+        int16_t readout_hp;
+        int16_t readout_mp;
+        int32_t readout_maxhp;
+        int32_t readout_maxmp;
         Texture quickslot[2];
         Texture menutitle[5];
         Texture menubackground[3];
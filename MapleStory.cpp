@@ -21,6 +21,7 @@
 #include "Net/Session.h"
 #include "Util/HardwareInfo.h"
 #include "Util/ScreenResolution.h"
+#include "Util/Simulation.h"
 #include "Util/Timer.h"
 
 //#ifdef NDEBUG
@@ -33,6 +34,8 @@
 #include "Util/WzFiles.h"
 #endif
 
+#include <iostream>
+
 namespace ms {
     Error init() {
         if (Error error = Session::get().init())
@@ -57,6 +60,7 @@ namespace ms {
 
         Char::init();
         FloatingNumber::init();
+        EffectLayer::init();
         MapPortals::init();
         Stage::get().init();
         UI::get().init();
@@ -158,15 +162,27 @@ namespace ms {
     }
 }
 
-#ifdef _DEBUG
+#if defined(_DEBUG) || defined(HEADLESS_SIMULATION)
 int main()
 #else
 int APIENTRY WinMain(HINSTANCE hInst, HINSTANCE hInstPrev, PSTR cmdline, int cmdshow)
 #endif
 {
+#ifdef HEADLESS_SIMULATION
+    ms::Simulation simulation;
+
+    if (ms::Error error = simulation.init()) {
+        std::cerr << error.get_message() << error.get_args() << std::endl;
+
+        return 1;
+    }
+
+    simulation.run();
+#else
     ms::HardwareInfo();
     ms::ScreenResolution();
     ms::start();
+#endif
 
     return 0;
 }
@@ -26,6 +26,12 @@
 // If defined use NX, otherwise use WZ.
 #define USE_NX
 
+// HEADLESS_SIMULATION runs a scripted map without window, audio or server and logs the update timings, see 'Simulation'.
+// It is defined by the 'MapleStorySim' target and the 'Simulation' configuration, not here. Requires USE_NX.
+#if defined(HEADLESS_SIMULATION) && !defined(USE_NX)
+#error "HEADLESS_SIMULATION requires USE_NX"
+#endif
+
 // Debug options
 #define LOG_ERROR	1
 #define LOG_WARN	2
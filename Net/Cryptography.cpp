@@ -17,7 +17,238 @@
 //////////////////////////////////////////////////////////////////////////////////
 #include "Cryptography.h"
 
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CRYPTO_AESNI
+#include <wmmintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AESNI_TARGET
+#else
+#include <cpuid.h>
+#define AESNI_TARGET __attribute__((target("aes,sse2")))
+#endif
+#endif
+
 namespace ms {
+    namespace {
+        // This key is already expanded
+        // Only works for versions lower than version 118
+        alignas(16) const uint8_t maplekey[256] =
+        {
+            0x13, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0xB4, 0x00, 0x00, 0x00,
+            0x1B, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x33, 0x00, 0x00, 0x00, 0x52, 0x00, 0x00, 0x00,
+            0x71, 0x63, 0x63, 0x00, 0x79, 0x63, 0x63, 0x00, 0x7F, 0x63, 0x63, 0x00, 0xCB, 0x63, 0x63, 0x00,
+            0x04, 0xFB, 0xFB, 0x63, 0x0B, 0xFB, 0xFB, 0x63, 0x38, 0xFB, 0xFB, 0x63, 0x6A, 0xFB, 0xFB, 0x63,
+            0x7C, 0x6C, 0x98, 0x02, 0x05, 0x0F, 0xFB, 0x02, 0x7A, 0x6C, 0x98, 0x02, 0xB1, 0x0F, 0xFB, 0x02,
+            0xCC, 0x8D, 0xF4, 0x14, 0xC7, 0x76, 0x0F, 0x77, 0xFF, 0x8D, 0xF4, 0x14, 0x95, 0x76, 0x0F, 0x77,
+            0x40, 0x1A, 0x6D, 0x28, 0x45, 0x15, 0x96, 0x2A, 0x3F, 0x79, 0x0E, 0x28, 0x8E, 0x76, 0xF5, 0x2A,
+            0xD5, 0xB5, 0x12, 0xF1, 0x12, 0xC3, 0x1D, 0x86, 0xED, 0x4E, 0xE9, 0x92, 0x78, 0x38, 0xE6, 0xE5,
+            0x4F, 0x94, 0xB4, 0x94, 0x0A, 0x81, 0x22, 0xBE, 0x35, 0xF8, 0x2C, 0x96, 0xBB, 0x8E, 0xD9, 0xBC,
+            0x3F, 0xAC, 0x27, 0x94, 0x2D, 0x6F, 0x3A, 0x12, 0xC0, 0x21, 0xD3, 0x80, 0xB8, 0x19, 0x35, 0x65,
+            0x8B, 0x02, 0xF9, 0xF8, 0x81, 0x83, 0xDB, 0x46, 0xB4, 0x7B, 0xF7, 0xD0, 0x0F, 0xF5, 0x2E, 0x6C,
+            0x49, 0x4A, 0x16, 0xC4, 0x64, 0x25, 0x2C, 0xD6, 0xA4, 0x04, 0xFF, 0x56, 0x1C, 0x1D, 0xCA, 0x33,
+            0x0F, 0x76, 0x3A, 0x64, 0x8E, 0xF5, 0xE1, 0x22, 0x3A, 0x8E, 0x16, 0xF2, 0x35, 0x7B, 0x38, 0x9E,
+            0xDF, 0x6B, 0x11, 0xCF, 0xBB, 0x4E, 0x3D, 0x19, 0x1F, 0x4A, 0xC2, 0x4F, 0x03, 0x57, 0x08, 0x7C,
+            0x14, 0x46, 0x2A, 0x1F, 0x9A, 0xB3, 0xCB, 0x3D, 0xA0, 0x3D, 0xDD, 0xCF, 0x95, 0x46, 0xE5, 0x51,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+        };
+
+        // Rijndael substitution box
+        const uint8_t subbox[256] =
+        {
+            0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
+            0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0, 0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
+            0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+            0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
+            0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0, 0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
+            0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+            0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
+            0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5, 0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
+            0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+            0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
+            0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C, 0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
+            0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+            0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
+            0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E, 0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
+            0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+            0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16
+        };
+
+        // Tables which combine the sub bytes, shift rows and mix columns steps of one column
+        struct AesTables {
+            uint32_t te[4][256];
+            uint32_t roundkeys[60];
+
+            AesTables() {
+                for (size_t i = 0; i < 256; i++) {
+                    uint8_t s = subbox[i];
+                    uint8_t s2 = static_cast<uint8_t>((s << 1) ^ ((s & 0x80) ? 0x1B : 0x00));
+                    uint8_t s3 = s2 ^ s;
+
+                    uint32_t word = (s2 << 24) | (s << 16) | (s << 8) | s3;
+
+                    te[0][i] = word;
+                    te[1][i] = (word >> 8) | (word << 24);
+                    te[2][i] = (word >> 16) | (word << 16);
+                    te[3][i] = (word >> 24) | (word << 8);
+                }
+
+                for (size_t i = 0; i < 60; i++)
+                    roundkeys[i] = load(maplekey + 4 * i);
+            }
+
+            static uint32_t load(const uint8_t* bytes) {
+                return (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+            }
+
+            static void store(uint8_t* bytes, uint32_t word) {
+                bytes[0] = static_cast<uint8_t>(word >> 24);
+                bytes[1] = static_cast<uint8_t>(word >> 16);
+                bytes[2] = static_cast<uint8_t>(word >> 8);
+                bytes[3] = static_cast<uint8_t>(word);
+            }
+        };
+
+        const AesTables& aestables() {
+            static const AesTables tables;
+
+            return tables;
+        }
+
+        void aesencrypt_tables(uint8_t* bytes) {
+            const AesTables& tables = aestables();
+            const uint32_t* rk = tables.roundkeys;
+            const uint32_t* te0 = tables.te[0];
+            const uint32_t* te1 = tables.te[1];
+            const uint32_t* te2 = tables.te[2];
+            const uint32_t* te3 = tables.te[3];
+
+            uint32_t s0 = AesTables::load(bytes) ^ rk[0];
+            uint32_t s1 = AesTables::load(bytes + 4) ^ rk[1];
+            uint32_t s2 = AesTables::load(bytes + 8) ^ rk[2];
+            uint32_t s3 = AesTables::load(bytes + 12) ^ rk[3];
+
+            for (size_t round = 1; round < 14; round++) {
+                rk += 4;
+
+                uint32_t t0 = te0[s0 >> 24] ^ te1[(s1 >> 16) & 0xFF] ^ te2[(s2 >> 8) & 0xFF] ^ te3[s3 & 0xFF] ^ rk[0];
+                uint32_t t1 = te0[s1 >> 24] ^ te1[(s2 >> 16) & 0xFF] ^ te2[(s3 >> 8) & 0xFF] ^ te3[s0 & 0xFF] ^ rk[1];
+                uint32_t t2 = te0[s2 >> 24] ^ te1[(s3 >> 16) & 0xFF] ^ te2[(s0 >> 8) & 0xFF] ^ te3[s1 & 0xFF] ^ rk[2];
+                uint32_t t3 = te0[s3 >> 24] ^ te1[(s0 >> 16) & 0xFF] ^ te2[(s1 >> 8) & 0xFF] ^ te3[s2 & 0xFF] ^ rk[3];
+
+                s0 = t0;
+                s1 = t1;
+                s2 = t2;
+                s3 = t3;
+            }
+
+            rk += 4;
+
+            // The last round has no mix columns step
+            auto last = [](uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+                return (subbox[a >> 24] << 24) | (subbox[(b >> 16) & 0xFF] << 16) |
+                       (subbox[(c >> 8) & 0xFF] << 8) | subbox[d & 0xFF];
+            };
+
+            AesTables::store(bytes, last(s0, s1, s2, s3) ^ rk[0]);
+            AesTables::store(bytes + 4, last(s1, s2, s3, s0) ^ rk[1]);
+            AesTables::store(bytes + 8, last(s2, s3, s0, s1) ^ rk[2]);
+            AesTables::store(bytes + 12, last(s3, s0, s1, s2) ^ rk[3]);
+        }
+
+#ifdef CRYPTO_AESNI
+        bool has_aesni() {
+#ifdef _MSC_VER
+            int info[4];
+            __cpuid(info, 1);
+
+            return (info[2] & (1 << 25)) != 0;
+#else
+            unsigned int eax, ebx, ecx, edx;
+
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+                return false;
+
+            return (ecx & bit_AES) != 0;
+#endif
+        }
+
+        AESNI_TARGET void aesencrypt_aesni(uint8_t* bytes) {
+            const __m128i* rk = reinterpret_cast<const __m128i*>(maplekey);
+
+            __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+            state = _mm_xor_si128(state, _mm_load_si128(rk));
+
+            for (size_t round = 1; round < 14; round++)
+                state = _mm_aesenc_si128(state, _mm_load_si128(rk + round));
+
+            state = _mm_aesenclast_si128(state, _mm_load_si128(rk + 14));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), state);
+        }
+#endif
+
+        // Choose the fastest implementation the processor supports
+        using AesFunction = void (*)(uint8_t*);
+
+        AesFunction select_aes() {
+#ifdef CRYPTO_AESNI
+            if (has_aesni())
+                return aesencrypt_aesni;
+#endif
+
+            return aesencrypt_tables;
+        }
+
+        AesFunction& aesfunction() {
+            static AesFunction function = select_aes();
+
+            return function;
+        }
+
+        uint8_t rol(uint8_t byte, uint8_t count) {
+            count &= 7;
+
+            return static_cast<uint8_t>((byte << count) | (byte >> ((8 - count) & 7)));
+        }
+
+        uint8_t ror(uint8_t byte, uint8_t count) {
+            count &= 7;
+
+            return static_cast<uint8_t>((byte >> count) | (byte << ((8 - count) & 7)));
+        }
+    }
+
+    bool Cryptography::set_backend(Backend backend) {
+        switch (backend) {
+        case Backend::TABLES:
+            aesfunction() = aesencrypt_tables;
+            return true;
+#ifdef CRYPTO_AESNI
+        case Backend::AESNI:
+            if (!has_aesni())
+                return false;
+
+            aesfunction() = aesencrypt_aesni;
+            return true;
+#endif
+        default:
+            return false;
+        }
+    }
+
+    Cryptography::Backend Cryptography::get_backend() {
+#ifdef CRYPTO_AESNI
+        if (aesfunction() == aesencrypt_aesni)
+            return Backend::AESNI;
+#endif
+
+        return Backend::TABLES;
+    }
+
     Cryptography::Cryptography(const int8_t* handshake) {
 #ifdef USE_CRYPTO
         for (size_t i = 0; i < HEADER_LENGTH; i++)
@@ -88,50 +319,56 @@ namespace ms {
 #endif
     }
 
-    void Cryptography::mapleencrypt(int8_t* bytes, size_t length) const {
+    void Cryptography::mapleencrypt(int8_t* data, size_t length) const {
+        uint8_t* bytes = reinterpret_cast<uint8_t*>(data);
+        uint8_t startlen = static_cast<uint8_t>(length & 0xFF);
+
         for (size_t j = 0; j < 3; j++) {
-            int8_t remember = 0;
-            int8_t datalen = static_cast<int8_t>(length & 0xFF);
+            uint8_t remember = 0;
+            uint8_t datalen = startlen;
 
             for (size_t i = 0; i < length; i++) {
-                int8_t cur = (rollleft(bytes[i], 3) + datalen) ^ remember;
+                uint8_t cur = static_cast<uint8_t>(rol(bytes[i], 3) + datalen) ^ remember;
                 remember = cur;
-                cur = rollright(cur, static_cast<int32_t>(datalen) & 0xFF);
-                bytes[i] = static_cast<int8_t>((~cur) & 0xFF) + 0x48;
+                cur = ror(cur, datalen);
+                bytes[i] = static_cast<uint8_t>(~cur + 0x48);
                 datalen--;
             }
 
             remember = 0;
-            datalen = static_cast<int8_t>(length & 0xFF);
+            datalen = startlen;
 
             for (size_t i = length; i--;) {
-                int8_t cur = (rollleft(bytes[i], 4) + datalen) ^ remember;
+                uint8_t cur = static_cast<uint8_t>(rol(bytes[i], 4) + datalen) ^ remember;
                 remember = cur;
-                bytes[i] = rollright(cur ^ 0x13, 3);
+                bytes[i] = ror(cur ^ 0x13, 3);
                 datalen--;
             }
         }
     }
 
-    void Cryptography::mapledecrypt(int8_t* bytes, size_t length) const {
+    void Cryptography::mapledecrypt(int8_t* data, size_t length) const {
+        uint8_t* bytes = reinterpret_cast<uint8_t*>(data);
+        uint8_t startlen = static_cast<uint8_t>(length & 0xFF);
+
         for (size_t i = 0; i < 3; i++) {
             uint8_t remember = 0;
-            uint8_t datalen = static_cast<uint8_t>(length & 0xFF);
+            uint8_t datalen = startlen;
 
             for (size_t j = length; j--;) {
-                uint8_t cur = rollleft(bytes[j], 3) ^ 0x13;
-                bytes[j] = rollright((cur ^ remember) - datalen, 4);
+                uint8_t cur = rol(bytes[j], 3) ^ 0x13;
+                bytes[j] = ror(static_cast<uint8_t>((cur ^ remember) - datalen), 4);
                 remember = cur;
                 datalen--;
             }
 
             remember = 0;
-            datalen = static_cast<uint8_t>(length & 0xFF);
+            datalen = startlen;
 
             for (size_t j = 0; j < length; j++) {
-                uint8_t cur = (~(bytes[j] - 0x48)) & 0xFF;
-                cur = rollleft(cur, static_cast<int32_t>(datalen) & 0xFF);
-                bytes[j] = rollright((cur ^ remember) - datalen, 3);
+                uint8_t cur = static_cast<uint8_t>(~(bytes[j] - 0x48));
+                cur = rol(cur, datalen);
+                bytes[j] = ror(static_cast<uint8_t>((cur ^ remember) - datalen), 3);
                 remember = cur;
                 datalen--;
             }
@@ -188,162 +425,60 @@ namespace ms {
             iv[i] = mbytes[i];
     }
 
-    int8_t Cryptography::rollleft(int8_t data, size_t count) const {
-        int32_t mask = (data & 0xFF) << (count % 8);
+    void Cryptography::aesofb(int8_t* bytes, size_t length, uint8_t* iv) const {
+        static constexpr size_t FIRSTBLOCK = 0x5B0;
+        static constexpr size_t BLOCK = 0x5B4;
 
-        return static_cast<int8_t>((mask & 0xFF) | (mask >> 8));
-    }
+        // Every block of the packet starts over from the same iv and so uses the same key stream
+        // Generate it once for the longest block needed, then apply it to each block
+        uint8_t keystream[(BLOCK + 15) / 16 * 16];
+        size_t streamlength = length < BLOCK ? length : BLOCK;
 
-    int8_t Cryptography::rollright(int8_t data, size_t count) const {
-        int32_t mask = ((data & 0xFF) << 8) >> (count % 8);
+        uint8_t miv[16];
 
-        return static_cast<int8_t>((mask & 0xFF) | (mask >> 8));
-    }
+        for (size_t i = 0; i < 16; i++)
+            miv[i] = iv[i % 4];
 
-    void Cryptography::aesofb(int8_t* bytes, size_t length, uint8_t* iv) const {
-        size_t blocklength = 0x5B0;
+        for (size_t x = 0; x < streamlength; x += 16) {
+            aesencrypt(miv);
+            memcpy(keystream + x, miv, 16);
+        }
+
+        size_t blocklength = FIRSTBLOCK;
         size_t offset = 0;
 
         while (offset < length) {
-            uint8_t miv[16];
-
-            for (size_t i = 0; i < 16; i++)
-                miv[i] = iv[i % 4];
-
             size_t remaining = length - offset;
 
             if (remaining > blocklength)
                 remaining = blocklength;
 
-            for (size_t x = 0; x < remaining; x++) {
-                size_t relpos = x % 16;
-
-                if (relpos == 0)
-                    aesencrypt(miv);
-
-                bytes[x + offset] ^= miv[relpos];
-            }
+            applykeystream(bytes + offset, keystream, remaining);
 
             offset += blocklength;
-            blocklength = 0x5B4;
+            blocklength = BLOCK;
         }
 
         updateiv(iv);
     }
 
-    void Cryptography::aesencrypt(uint8_t* bytes) const {
-        uint8_t round = 0;
-        addroundkey(bytes, round);
-
-        for (round = 1; round < 14; round++) {
-            subbytes(bytes);
-            shiftrows(bytes);
-            mixcolumns(bytes);
-            addroundkey(bytes, round);
-        }
-
-        subbytes(bytes);
-        shiftrows(bytes);
-        addroundkey(bytes, round);
-    }
-
-    void Cryptography::addroundkey(uint8_t* bytes, uint8_t round) const {
-        // This key is already expanded
-        // Only works for versions lower than version 118
-        static const uint8_t maplekey[256] =
-        {
-            0x13, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0xB4, 0x00, 0x00, 0x00,
-            0x1B, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x33, 0x00, 0x00, 0x00, 0x52, 0x00, 0x00, 0x00,
-            0x71, 0x63, 0x63, 0x00, 0x79, 0x63, 0x63, 0x00, 0x7F, 0x63, 0x63, 0x00, 0xCB, 0x63, 0x63, 0x00,
-            0x04, 0xFB, 0xFB, 0x63, 0x0B, 0xFB, 0xFB, 0x63, 0x38, 0xFB, 0xFB, 0x63, 0x6A, 0xFB, 0xFB, 0x63,
-            0x7C, 0x6C, 0x98, 0x02, 0x05, 0x0F, 0xFB, 0x02, 0x7A, 0x6C, 0x98, 0x02, 0xB1, 0x0F, 0xFB, 0x02,
-            0xCC, 0x8D, 0xF4, 0x14, 0xC7, 0x76, 0x0F, 0x77, 0xFF, 0x8D, 0xF4, 0x14, 0x95, 0x76, 0x0F, 0x77,
-            0x40, 0x1A, 0x6D, 0x28, 0x45, 0x15, 0x96, 0x2A, 0x3F, 0x79, 0x0E, 0x28, 0x8E, 0x76, 0xF5, 0x2A,
-            0xD5, 0xB5, 0x12, 0xF1, 0x12, 0xC3, 0x1D, 0x86, 0xED, 0x4E, 0xE9, 0x92, 0x78, 0x38, 0xE6, 0xE5,
-            0x4F, 0x94, 0xB4, 0x94, 0x0A, 0x81, 0x22, 0xBE, 0x35, 0xF8, 0x2C, 0x96, 0xBB, 0x8E, 0xD9, 0xBC,
-            0x3F, 0xAC, 0x27, 0x94, 0x2D, 0x6F, 0x3A, 0x12, 0xC0, 0x21, 0xD3, 0x80, 0xB8, 0x19, 0x35, 0x65,
-            0x8B, 0x02, 0xF9, 0xF8, 0x81, 0x83, 0xDB, 0x46, 0xB4, 0x7B, 0xF7, 0xD0, 0x0F, 0xF5, 0x2E, 0x6C,
-            0x49, 0x4A, 0x16, 0xC4, 0x64, 0x25, 0x2C, 0xD6, 0xA4, 0x04, 0xFF, 0x56, 0x1C, 0x1D, 0xCA, 0x33,
-            0x0F, 0x76, 0x3A, 0x64, 0x8E, 0xF5, 0xE1, 0x22, 0x3A, 0x8E, 0x16, 0xF2, 0x35, 0x7B, 0x38, 0x9E,
-            0xDF, 0x6B, 0x11, 0xCF, 0xBB, 0x4E, 0x3D, 0x19, 0x1F, 0x4A, 0xC2, 0x4F, 0x03, 0x57, 0x08, 0x7C,
-            0x14, 0x46, 0x2A, 0x1F, 0x9A, 0xB3, 0xCB, 0x3D, 0xA0, 0x3D, 0xDD, 0xCF, 0x95, 0x46, 0xE5, 0x51,
-            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
-        };
-
-        uint8_t offset = round * 16;
-
-        for (uint8_t i = 0; i < 16; i++)
-            bytes[i] ^= maplekey[i + offset];
-    }
-
-    void Cryptography::subbytes(uint8_t* bytes) const {
-        // Rijndael substitution box
-        static const uint8_t subbox[256] =
-        {
-            0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
-            0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0, 0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
-            0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
-            0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
-            0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0, 0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
-            0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
-            0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
-            0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5, 0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
-            0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
-            0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
-            0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C, 0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
-            0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
-            0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
-            0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E, 0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
-            0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
-            0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16
-        };
-
-        for (uint8_t i = 0; i < 16; i++)
-            bytes[i] = subbox[bytes[i]];
-    }
+    void Cryptography::applykeystream(int8_t* bytes, const uint8_t* keystream, size_t length) const {
+        size_t x = 0;
 
-    void Cryptography::shiftrows(uint8_t* bytes) const {
-        uint8_t remember = bytes[1];
-        bytes[1] = bytes[5];
-        bytes[5] = bytes[9];
-        bytes[9] = bytes[13];
-        bytes[13] = remember;
-
-        remember = bytes[10];
-        bytes[10] = bytes[2];
-        bytes[2] = remember;
-
-        remember = bytes[3];
-        bytes[3] = bytes[15];
-        bytes[15] = bytes[11];
-        bytes[11] = bytes[7];
-        bytes[7] = remember;
-
-        remember = bytes[14];
-        bytes[14] = bytes[6];
-        bytes[6] = remember;
-    }
+        for (; x + 8 <= length; x += 8) {
+            uint64_t word;
+            uint64_t key;
+            memcpy(&word, bytes + x, 8);
+            memcpy(&key, keystream + x, 8);
+            word ^= key;
+            memcpy(bytes + x, &word, 8);
+        }
 
-    uint8_t Cryptography::gmul(uint8_t x) const {
-        return (x << 1) ^ (0x1B & static_cast<uint8_t>(static_cast<int8_t>(x) >> 7));
+        for (; x < length; x++)
+            bytes[x] ^= keystream[x];
     }
 
-    void Cryptography::mixcolumns(uint8_t* bytes) const {
-        for (uint8_t i = 0; i < 16; i += 4) {
-            uint8_t cpy0 = bytes[i];
-            uint8_t cpy1 = bytes[i + 1];
-            uint8_t cpy2 = bytes[i + 2];
-            uint8_t cpy3 = bytes[i + 3];
-
-            uint8_t mul0 = gmul(bytes[i]);
-            uint8_t mul1 = gmul(bytes[i + 1]);
-            uint8_t mul2 = gmul(bytes[i + 2]);
-            uint8_t mul3 = gmul(bytes[i + 3]);
-
-            bytes[i] = mul0 ^ cpy3 ^ cpy2 ^ mul1 ^ cpy1;
-            bytes[i + 1] = mul1 ^ cpy0 ^ cpy3 ^ mul2 ^ cpy2;
-            bytes[i + 2] = mul2 ^ cpy1 ^ cpy0 ^ mul3 ^ cpy3;
-            bytes[i + 3] = mul3 ^ cpy2 ^ cpy1 ^ mul0 ^ cpy0;
-        }
+    void Cryptography::aesencrypt(uint8_t* bytes) const {
+        aesfunction()(bytes);
     }
 }
@@ -25,6 +25,19 @@ namespace ms {
     // Used to encrypt and decrypt packets for communication with the server
     class Cryptography {
     public:
+        // The implementations of the AES block encryption, all produce the same output
+        enum Backend : uint8_t {
+            TABLES,
+            AESNI,
+            NUM_BACKENDS
+        };
+
+        // Select the implementation used by all instances, returns false if the processor does not support it
+        // Should be called before any packets are encrypted
+        static bool set_backend(Backend backend);
+        // Return the implementation in use, by default the fastest one the processor supports
+        static Backend get_backend();
+
         // Obtain the initialization vector from the handshake
         Cryptography(const int8_t* handshake);
         Cryptography();
@@ -46,25 +59,14 @@ namespace ms {
         void mapledecrypt(int8_t* bytes, size_t length) const;
         // Update a key
         void updateiv(uint8_t* iv) const;
-        // Perform a roll-left operation
-        int8_t rollleft(int8_t byte, size_t count) const;
-        // Perform a roll-right operation
-        int8_t rollright(int8_t byte, size_t count) const;
 
         // Apply AES OFB to a byte array
         void aesofb(int8_t* bytes, size_t length, uint8_t* iv) const;
-        // Encrypt a byte array with AES
+        // Xor a byte array with a generated key stream
+        void applykeystream(int8_t* bytes, const uint8_t* keystream, size_t length) const;
+        // Encrypt a block of 16 bytes with AES
+        // Uses AES-NI instructions if the processor has them, otherwise lookup tables
         void aesencrypt(uint8_t* bytes) const;
-        // AES add round key step
-        void addroundkey(uint8_t* bytes, uint8_t round) const;
-        // AES sub bytes step
-        void subbytes(uint8_t* bytes) const;
-        // AES shift rows step
-        void shiftrows(uint8_t* bytes) const;
-        // AES mix columns step
-        void mixcolumns(uint8_t* bytes) const;
-        // Perform a Galois multiplication
-        uint8_t gmul(uint8_t byte) const;
 
 #ifdef USE_CRYPTO
         uint8_t sendiv[HEADER_LENGTH];
@@ -37,7 +37,7 @@ namespace ms {
             recv.read_byte(); // 'buddycap'
 
             if (recv.read_bool())
-                recv.read_string(); // 'linkedname'
+                recv.skip_string(); // 'linkedname'
 
             CharacterParser::parse_inventory(recv, player.get_inventory());
             CharacterParser::parse_skillbook(recv, player.get_skills());
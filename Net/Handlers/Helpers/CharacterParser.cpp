@@ -113,7 +113,7 @@ namespace ms {
 
         for (int16_t i = 0; i < rsize; i++) {
             recv.read_int();
-            recv.read_padded_string(13);
+            recv.skip_padded_string(13); // partner name
             recv.read_int();
             recv.read_int();
             recv.read_int();
@@ -126,7 +126,7 @@ namespace ms {
 
         for (int16_t i = 0; i < rsize; i++) {
             recv.read_int();
-            recv.read_padded_string(13);
+            recv.skip_padded_string(13); // partner name
             recv.read_int();
             recv.read_int();
             recv.read_int();
@@ -145,8 +145,8 @@ namespace ms {
             recv.read_short();
             recv.read_int();
             recv.read_int();
-            recv.read_padded_string(13);
-            recv.read_padded_string(13);
+            recv.skip_padded_string(13);
+            recv.skip_padded_string(13);
         }
     }
 
@@ -183,15 +183,15 @@ namespace ms {
         for (int16_t i = 0; i < nysize; i++) {
             recv.read_int(); // NewYear Id
             recv.read_int(); // NewYear SenderId
-            recv.read_string(); // NewYear SenderName
+            recv.skip_string(); // NewYear SenderName
             recv.read_bool(); // NewYear enderCardDiscarded
             recv.read_long(); // NewYear DateSent
             recv.read_int(); // NewYear ReceiverId
-            recv.read_string(); // NewYear ReceiverName
+            recv.skip_string(); // NewYear ReceiverName
             recv.read_bool(); // NewYear eceiverCardDiscarded
             recv.read_bool(); // NewYear eceiverCardReceived
             recv.read_long(); // NewYear DateReceived
-            recv.read_string(); // NewYear Message
+            recv.skip_string(); // NewYear Message
         }
     }
 
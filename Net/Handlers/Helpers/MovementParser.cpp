@@ -21,6 +21,7 @@ namespace ms {
     std::vector<Movement> MovementParser::parse_movements(InPacket& recv) {
         std::vector<Movement> movements;
         uint8_t length = recv.read_byte();
+        movements.reserve(length);
 
         for (uint8_t i = 0; i < length; ++i) {
             Movement fragment;
@@ -31,13 +32,8 @@ namespace ms {
             case 5:
             case 17:
                 fragment.type = Movement::ABSOLUTE;
-                fragment.xpos = recv.read_short();
-                fragment.ypos = recv.read_short();
-                fragment.lastx = recv.read_short();
-                fragment.lasty = recv.read_short();
-                fragment.fh = recv.read_short();
-                fragment.newstate = recv.read_byte();
-                fragment.duration = recv.read_short();
+                recv.read_fields(fragment.xpos, fragment.ypos, fragment.lastx, fragment.lasty, fragment.fh,
+                                 fragment.newstate, fragment.duration);
                 break;
             case 1:
             case 2:
@@ -46,29 +42,17 @@ namespace ms {
             case 13:
             case 16:
                 fragment.type = Movement::RELATIVE;
-                fragment.xpos = recv.read_short();
-                fragment.ypos = recv.read_short();
-                fragment.newstate = recv.read_byte();
-                fragment.duration = recv.read_short();
+                recv.read_fields(fragment.xpos, fragment.ypos, fragment.newstate, fragment.duration);
                 break;
             case 11:
                 fragment.type = Movement::CHAIR;
-                fragment.xpos = recv.read_short();
-                fragment.ypos = recv.read_short();
-                recv.skip(2);
-                fragment.newstate = recv.read_byte();
-                fragment.duration = recv.read_short();
+                recv.read_fields(fragment.xpos, fragment.ypos, InPacket::Padding<2>(), fragment.newstate,
+                                 fragment.duration);
                 break;
             case 15:
                 fragment.type = Movement::JUMPDOWN;
-                fragment.xpos = recv.read_short();
-                fragment.ypos = recv.read_short();
-                fragment.lastx = recv.read_short();
-                fragment.lasty = recv.read_short();
-                recv.skip(2);
-                fragment.fh = recv.read_short();
-                fragment.newstate = recv.read_byte();
-                fragment.duration = recv.read_short();
+                recv.read_fields(fragment.xpos, fragment.ypos, fragment.lastx, fragment.lasty, InPacket::Padding<2>(),
+                                 fragment.fh, fragment.newstate, fragment.duration);
                 break;
             case 3:
             case 4:
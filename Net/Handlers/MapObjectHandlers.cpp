@@ -33,7 +33,7 @@ namespace ms {
         uint16_t level = recv.read_short();
         std::string name = recv.read_string();
 
-        recv.read_string(); // guildname
+        recv.skip_string(); // guildname
         recv.read_short(); // guildlogobg
         recv.read_byte(); // guildlogobgcolor
         recv.read_short(); // guildlogo
@@ -74,7 +74,7 @@ namespace ms {
             if (available == 1) {
                 recv.read_byte(); // 'byte2'
                 recv.read_int(); // petid
-                recv.read_string(); // name
+                recv.skip_string(); // name
                 recv.read_int(); // unique id
                 recv.read_int();
                 recv.read_point(); // pos
@@ -181,19 +181,16 @@ namespace ms {
     }
 
     void SpawnMobHandler::handle(InPacket& recv) {
-        int32_t oid = recv.read_int();
-        recv.read_byte(); // 5 if controller == null
-        int32_t id = recv.read_int();
-
-        recv.skip(16);
-
-        Point<int16_t> position = recv.read_point();
-        int8_t stance = recv.read_byte();
-
-        recv.skip(2);
-
-        uint16_t fh = recv.read_short();
-        int8_t effect = recv.read_byte();
+        int32_t oid;
+        int32_t id;
+        Point<int16_t> position;
+        int8_t stance;
+        uint16_t fh;
+        int8_t effect;
+
+        // The byte after the oid is 5 if controller == null
+        recv.read_fields(oid, InPacket::Padding<1>(), id, InPacket::Padding<16>(), position, stance,
+                         InPacket::Padding<2>(), fh, effect);
 
         if (effect > 0) {
             recv.read_byte();
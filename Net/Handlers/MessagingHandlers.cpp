@@ -145,7 +145,8 @@ namespace ms {
             recv.skip_byte();
 
         std::string error = "[MessagingHandlers::ServerMessageHandler]: ";
-        const std::string& message = recv.read_string();
+        // Only some types show the message, it is copied when needed
+        StringView message = recv.read_string_view();
 
         if (type == 3) {
             int8_t channel = recv.read_byte();
@@ -158,10 +159,10 @@ namespace ms {
             show_message(error.c_str(), UIChatBar::MessageType::RED);
 #endif
         } else if (type == 4) {
-            UI::get().set_scrollnotice(message);
+            UI::get().set_scrollnotice(message.to_string());
         } else if (type == 5) {
             // TODO: Is this actually white?
-            show_message(message.c_str(), UIChatBar::MessageType::WHITE);
+            show_message(message.to_string().c_str(), UIChatBar::MessageType::WHITE);
         } else if (type == 6) {
             recv.skip_int();
 
@@ -190,14 +191,16 @@ namespace ms {
     void WeekEventMessageHandler::handle(InPacket& recv) {
         recv.read_byte(); // TODO: Always 0xFF, Check this!
 
-        std::string message = recv.read_string();
+        StringView message = recv.read_string_view();
 
         static const std::string MAPLETIP = "[MapleTip]";
 
-        if (message.substr(0, MAPLETIP.length()).compare("[MapleTip]"))
-            message = "[Notice] " + message;
+        std::string text = message.to_string();
+
+        if (!message.starts_with(StringView(MAPLETIP.data(), MAPLETIP.size())))
+            text = "[Notice] " + text;
 
-        show_message(message.c_str(), UIChatBar::MessageType::YELLOW);
+        show_message(text.c_str(), UIChatBar::MessageType::YELLOW);
     }
 
     void ChatReceivedHandler::handle(InPacket& recv) {
@@ -272,9 +275,9 @@ namespace ms {
         } else if (mode1 == 13) { // card effect
             Stage::get().get_player().show_effect_id(CharEffect::Id::MONSTER_CARD);
         } else if (mode1 == 18) { // intro effect
-            recv.read_string(); // path
+            recv.skip_string(); // path
         } else if (mode1 == 23) { // info
-            recv.read_string(); // path
+            recv.skip_string(); // path
             recv.read_int(); // some int
         } else { // Buff effect
             int32_t skillid = recv.read_int();
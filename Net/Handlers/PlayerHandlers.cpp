@@ -190,7 +190,7 @@ namespace ms {
         uint8_t size = recv.read_byte();
 
         for (uint8_t i = 0; i < size; i++) {
-            recv.read_string(); // name
+            recv.skip_string(); // name
             recv.read_byte(); // 'shout' byte
             recv.read_int(); // skill 1
             recv.read_int(); // skill 2
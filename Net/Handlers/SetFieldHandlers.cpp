@@ -34,6 +34,9 @@ namespace ms {
     void SetFieldHandler::transition(int32_t mapid, uint8_t portalid) const {
         float fadestep = 0.025f;
 
+        // Parse the new map while the screen fades out
+        Stage::get().prefetch(mapid);
+
         Window::get().fadeout(
             fadestep,
             [mapid, portalid]() {
@@ -99,7 +102,7 @@ namespace ms {
         recv.read_byte(); // 'buddycap'
 
         if (recv.read_bool())
-            recv.read_string(); // 'linkedname'
+            recv.skip_string(); // 'linkedname'
 
         CharacterParser::parse_inventory(recv, player.get_inventory());
         CharacterParser::parse_skillbook(recv, player.get_skills());
@@ -17,6 +17,8 @@
 //////////////////////////////////////////////////////////////////////////////////
 #include "InPacket.h"
 
+#include <algorithm>
+
 namespace ms {
     InPacket::InPacket(const int8_t* recv, size_t length) {
         bytes = recv;
@@ -60,29 +62,33 @@ namespace ms {
     }
 
     Point<int16_t> InPacket::read_point() {
-        int16_t x = read<int16_t>();
-        int16_t y = read<int16_t>();
+        Point<int16_t> point;
+        read_fields(point);
 
-        return Point<int16_t>(x, y);
+        return point;
     }
 
     std::string InPacket::read_string() {
-        uint16_t length = read<uint16_t>();
-
-        return read_padded_string(length);
+        return read_string_view().to_string();
     }
 
     std::string InPacket::read_padded_string(uint16_t count) {
-        std::string ret;
+        return read_padded_string_view(count).to_string();
+    }
+
+    StringView InPacket::read_string_view() {
+        uint16_t length = read<uint16_t>();
+
+        return read_padded_string_view(length);
+    }
 
-        for (int16_t i = 0; i < count; i++) {
-            char letter = read_byte();
+    StringView InPacket::read_padded_string_view(uint16_t count) {
+        const char* first = reinterpret_cast<const char*>(bytes + pos);
+        skip(count);
 
-            if (letter != '\0')
-                ret.push_back(letter);
-        }
+        const char* last = std::find(first, first + count, '\0');
 
-        return ret;
+        return {first, static_cast<size_t>(last - first)};
     }
 
     void InPacket::skip_bool() {
@@ -20,14 +20,21 @@
 #include "PacketError.h"
 
 #include "../Template/Point.h"
+#include "../Template/StringView.h"
 
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
 
 namespace ms {
     // A packet received from the server
     // Contains reading functions
     class InPacket {
     public:
+        // A number of bytes skipped by 'read_fields'
+        template <size_t N>
+        struct Padding {};
+
         // Construct a packet from an array of bytes
         InPacket(const int8_t* bytes, size_t length);
 
@@ -53,9 +60,25 @@ namespace ms {
         Point<int16_t> read_point();
 
         // Read a string
+        // All string readers skip the whole field but end the string at its first null character
         std::string read_string();
         // Read a fixed-length string
         std::string read_padded_string(uint16_t length);
+        // Read a string without copying it, the view is only valid while the packet's bytes are
+        StringView read_string_view();
+        // Read a fixed-length string without copying it
+        StringView read_padded_string_view(uint16_t length);
+
+        // Read a fixed layout of fields in order with a single bounds check
+        // Fields can be integers, bools, points or 'Padding'
+        template <typename... Fields>
+        void read_fields(Fields&&... fields) {
+            const int8_t* at = bytes + pos;
+            skip(layout_size<std::decay_t<Fields>...>());
+
+            int order[] = {0, (at += load_field(at, std::forward<Fields>(fields)), 0)...};
+            (void)order;
+        }
 
         // Skip a byte
         void skip_bool();
@@ -89,19 +112,75 @@ namespace ms {
 
     private:
         template <typename T>
-        // Read a number and advance the buffer position
-        T read() {
-            size_t count = sizeof(T) / sizeof(int8_t);
-            T all = 0;
+        struct FieldSize {
+            static constexpr size_t value = sizeof(T);
+        };
+
+        template <size_t N>
+        struct FieldSize<Padding<N>> {
+            static constexpr size_t value = N;
+        };
+
+        template <typename T>
+        struct FieldSize<Point<T>> {
+            static constexpr size_t value = 2 * sizeof(T);
+        };
+
+        template <typename... Fields>
+        static constexpr size_t layout_size() {
+            size_t sizes[] = {0, FieldSize<Fields>::value...};
+            size_t total = 0;
+
+            for (size_t size : sizes)
+                total += size;
+
+            return total;
+        }
+
+        template <typename T>
+        // Load a little-endian number from the bytes, the bounds have already been checked
+        // Packets and all platforms the client runs on are little-endian, so this is a single load
+        static T load(const int8_t* at) {
+            static_assert(std::is_integral<T>::value, "InPacket::load - Only integers can be loaded");
+
+            T value;
+            std::memcpy(&value, at, sizeof(T));
+
+            return value;
+        }
+
+        template <typename T>
+        static size_t load_field(const int8_t* at, T& field) {
+            field = load<T>(at);
+
+            return sizeof(T);
+        }
+
+        static size_t load_field(const int8_t* at, bool& field) {
+            field = at[0] == 1;
+
+            return sizeof(int8_t);
+        }
 
-            for (size_t i = 0; i < count; i++) {
-                T val = static_cast<uint8_t>(bytes[pos]);
-                all += val << (8 * i);
+        template <typename T>
+        static size_t load_field(const int8_t* at, Point<T>& field) {
+            field = Point<T>(load<T>(at), load<T>(at + sizeof(T)));
+
+            return 2 * sizeof(T);
+        }
+
+        template <size_t N>
+        static size_t load_field(const int8_t*, Padding<N>) {
+            return N;
+        }
 
-                skip(1);
-            }
+        template <typename T>
+        // Read a number and advance the buffer position
+        T read() {
+            const int8_t* at = bytes + pos;
+            skip(sizeof(T));
 
-            return static_cast<T>(all);
+            return load<T>(at);
         }
 
         template <typename T>
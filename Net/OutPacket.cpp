@@ -17,21 +17,47 @@
 //////////////////////////////////////////////////////////////////////////////////
 #include "OutPacket.h"
 
+#include "PacketRecorder.h"
 #include "Session.h"
 
 #include "../Configuration.h"
 
 #include "../Util/Randomizer.h"
 
+#include <algorithm>
 #include <chrono>
 
 namespace ms {
-    OutPacket::OutPacket(int16_t opc) : opcode(opc) {
+    namespace {
+        constexpr size_t POOLSIZE = 16;
+        constexpr size_t INITIALSIZE = 256;
+
+        // Buffers of packets which have been sent
+        // Packets are only created and sent on the game thread
+        std::vector<std::vector<int8_t>> pool;
+    }
+
+    OutPacket::OutPacket(int16_t opc) : length(HEADER_LENGTH), opcode(opc) {
+        if (pool.empty()) {
+            bytes.resize(INITIALSIZE);
+        } else {
+            bytes = std::move(pool.back());
+            pool.pop_back();
+        }
+
         write_short(opcode);
     }
 
+    OutPacket::~OutPacket() {
+        if (pool.size() < POOLSIZE && !bytes.empty())
+            pool.push_back(std::move(bytes));
+    }
+
     void OutPacket::dispatch() {
-        Session::get().write(bytes.data(), bytes.size());
+        // Record before writing, since the session encrypts the bytes in place
+        PacketRecorder::get().record_outbound(bytes.data() + HEADER_LENGTH, length - HEADER_LENGTH);
+
+        Session::get().write(bytes.data(), length);
 
         if (Configuration::get().get_show_packets()) {
             if (opcode == PONG)
@@ -41,34 +67,37 @@ namespace ms {
         }
     }
 
+    int8_t* OutPacket::grow(size_t count) {
+        size_t required = length + count;
+
+        if (required > bytes.size())
+            bytes.resize(std::max(required, 2 * bytes.size()));
+
+        int8_t* position = bytes.data() + length;
+        length = required;
+
+        return position;
+    }
+
     void OutPacket::skip(size_t count) {
-        for (size_t i = 0; i < count; i++)
-            bytes.push_back(0);
+        memset(grow(count), 0, count);
     }
 
     void OutPacket::write_byte(int8_t ch) {
-        bytes.push_back(ch);
+        *grow(1) = ch;
     }
 
+    // Values are sent in little endian order, which is also the byte order of the client's platforms
     void OutPacket::write_short(int16_t sh) {
-        for (size_t i = 0; i < sizeof(short); i++) {
-            write_byte(static_cast<int8_t>(sh));
-            sh >>= 8;
-        }
+        write_value(sh);
     }
 
     void OutPacket::write_int(int32_t in) {
-        for (size_t i = 0; i < sizeof(int); i++) {
-            write_byte(static_cast<int8_t>(in));
-            in >>= 8;
-        }
+        write_value(in);
     }
 
     void OutPacket::write_long(int64_t lg) {
-        for (size_t i = 0; i < sizeof(long); i++) {
-            write_byte(static_cast<int8_t>(lg));
-            lg >>= 8;
-        }
+        write_value(static_cast<long>(lg));
     }
 
     void OutPacket::write_time() {
@@ -85,12 +114,12 @@ namespace ms {
     }
 
     void OutPacket::write_string(const std::string& str) {
-        int16_t length = static_cast<int16_t>(str.length());
+        int16_t strlength = static_cast<int16_t>(str.length());
 
-        write_short(length);
+        write_short(strlength);
 
-        for (int16_t i = 0; i < length; i++)
-            write_byte(str[i]);
+        if (strlength > 0)
+            memcpy(grow(strlength), str.data(), strlength);
     }
 
     void OutPacket::write_random() {
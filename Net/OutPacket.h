@@ -17,8 +17,11 @@
 //////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include "NetConstants.h"
+
 #include "../Template/Point.h"
 
+#include <cstring>
 #include <vector>
 
 namespace ms {
@@ -27,7 +30,13 @@ namespace ms {
     class OutPacket {
     public:
         // Construct a packet by writing its opcode
+        // The buffer is taken from a pool and has room for the header in front
         OutPacket(int16_t opcode);
+        // Return the buffer to the pool
+        ~OutPacket();
+
+        OutPacket(const OutPacket&) = default;
+        OutPacket& operator=(const OutPacket&) = default;
 
         void dispatch();
 
@@ -130,7 +139,17 @@ namespace ms {
         int32_t hex_to_dec(std::string hexVal);
 
     private:
+        // Make room for the specified number of bytes and return where to write them
+        int8_t* grow(size_t count);
+
+        template <typename T>
+        void write_value(T value) {
+            memcpy(grow(sizeof(T)), &value, sizeof(T));
+        }
+
+        // The first HEADER_LENGTH bytes are reserved for the header, only the first 'length' bytes are in use
         std::vector<int8_t> bytes;
+        size_t length;
         int16_t opcode;
     };
 }
@@ -0,0 +1,71 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "PacketBuffer.h"
+
+#include <cstring>
+
+namespace ms {
+    PacketBuffer::PacketBuffer() : buffer(std::make_unique<int8_t[]>(CAPACITY)), read(0), write(0) {
+    }
+
+    int8_t* PacketBuffer::tail() {
+        return buffer.get() + write;
+    }
+
+    size_t PacketBuffer::writable() const {
+        return CAPACITY - write;
+    }
+
+    void PacketBuffer::commit(size_t count) {
+        write += count;
+    }
+
+    int8_t* PacketBuffer::head() {
+        return buffer.get() + read;
+    }
+
+    size_t PacketBuffer::readable() const {
+        return write - read;
+    }
+
+    void PacketBuffer::consume(size_t count) {
+        read += count;
+
+        if (read == write) {
+            read = 0;
+            write = 0;
+        }
+    }
+
+    void PacketBuffer::reserve() {
+        if (writable() >= HEADER_LENGTH + MAX_PACKET_LENGTH || read == 0)
+            return;
+
+        // At most one unfinished packet remains, so this moves less than the space it frees
+        size_t remaining = readable();
+        memmove(buffer.get(), buffer.get() + read, remaining);
+
+        read = 0;
+        write = remaining;
+    }
+
+    void PacketBuffer::clear() {
+        read = 0;
+        write = 0;
+    }
+}
@@ -0,0 +1,58 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "NetConstants.h"
+
+#include <memory>
+
+namespace ms {
+    // Receive buffer that packets are reassembled, decrypted and handled in without copying
+    // The socket writes at the tail and complete packets are read from the head
+    // Once there is not enough room left for a full packet, the unfinished bytes are moved to the front
+    class PacketBuffer {
+    public:
+        PacketBuffer();
+
+        // Return the position the socket should write to
+        int8_t* tail();
+        // Return how many bytes can be written at the tail
+        size_t writable() const;
+        // Mark the given number of bytes at the tail as received
+        void commit(size_t count);
+
+        // Return the position of the oldest unhandled byte
+        int8_t* head();
+        // Return how many received bytes have not been handled yet
+        size_t readable() const;
+        // Mark the given number of bytes at the head as handled
+        void consume(size_t count);
+
+        // Make room for at least one packet of the maximum size at the tail
+        void reserve();
+        // Discard all received bytes
+        void clear();
+
+    private:
+        static constexpr size_t CAPACITY = 2 * (HEADER_LENGTH + MAX_PACKET_LENGTH);
+
+        std::unique_ptr<int8_t[]> buffer;
+        size_t read;
+        size_t write;
+    };
+}
@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "PacketRecorder.h"
+
+#include "../MapleStory.h"
+
+namespace ms {
+    PacketRecorder::PacketRecorder() {
+        reset_stats();
+    }
+
+    bool PacketRecorder::start(const std::string& path) {
+        stop();
+
+        file.open(path, std::ios::binary | std::ios::trunc);
+
+        if (!file) {
+            LOG(LOG_ERROR, "Could not open packet capture [" << path << "]");
+
+            return false;
+        }
+
+        file.write("MSPC", 4);
+        write_value<uint16_t>(VERSION);
+
+        last = std::chrono::steady_clock::now();
+
+        LOG(LOG_INFO, "Recording packets to [" << path << "]");
+
+        return true;
+    }
+
+    void PacketRecorder::stop() {
+        if (file.is_open())
+            file.close();
+    }
+
+    bool PacketRecorder::is_recording() const {
+        return file.is_open();
+    }
+
+    void PacketRecorder::record_inbound(const int8_t* bytes, size_t length) {
+        record(INBOUND, bytes, length);
+    }
+
+    void PacketRecorder::record_outbound(const int8_t* bytes, size_t length) {
+        record(OUTBOUND, bytes, length);
+    }
+
+    void PacketRecorder::record_handler_time(uint16_t opcode, int64_t time) {
+        if (opcode < NUM_OPCODES)
+            stats[INBOUND][opcode].time += time;
+    }
+
+    const std::array<PacketRecorder::OpcodeStats, PacketRecorder::NUM_OPCODES>& PacketRecorder::get_stats(
+        Direction direction) const {
+        return stats[direction];
+    }
+
+    void PacketRecorder::reset_stats() {
+        for (auto& opcodes : stats)
+            opcodes.fill({0, 0, 0});
+    }
+
+    void PacketRecorder::record(Direction direction, const int8_t* bytes, size_t length) {
+        if (length >= sizeof(uint16_t)) {
+            uint16_t opcode = static_cast<uint8_t>(bytes[0]) | static_cast<uint8_t>(bytes[1]) << 8;
+
+            if (opcode < NUM_OPCODES) {
+                OpcodeStats& opcodestats = stats[direction][opcode];
+                opcodestats.count++;
+                opcodestats.bytes += length;
+            }
+        }
+
+        if (file.is_open())
+            write(direction, bytes, length);
+    }
+
+    void PacketRecorder::write(Direction direction, const int8_t* bytes, size_t length) {
+        auto now = std::chrono::steady_clock::now();
+        auto delta = std::chrono::duration_cast<std::chrono::microseconds>(now - last).count();
+
+        // Advance by the written delta so that rounding does not accumulate
+        last += std::chrono::microseconds(delta);
+
+        write_value<uint8_t>(direction);
+        write_value<uint32_t>(static_cast<uint32_t>(delta));
+        write_value<uint32_t>(static_cast<uint32_t>(length));
+        file.write(reinterpret_cast<const char*>(bytes), length);
+    }
+}
@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "../Template/Singleton.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace ms {
+    // Counts the packets of each opcode and optionally writes all packets to a capture file
+    // Captures start with the magic "MSPC" and a version short, followed by one record per packet:
+    // a direction byte, the microseconds since the previous record as an int, the length as an int and the bytes
+    // The bytes are decrypted and start with the opcode, all numbers are little-endian
+    class PacketRecorder : public Singleton<PacketRecorder> {
+    public:
+        enum Direction : uint8_t {
+            INBOUND,
+            OUTBOUND,
+            NUM_DIRECTIONS
+        };
+
+        struct OpcodeStats {
+            size_t count;
+            size_t bytes;
+            // Nanoseconds spent in the handler, only measured for inbound packets
+            int64_t time;
+        };
+
+        // Opcodes of both directions are smaller than this
+        static constexpr size_t NUM_OPCODES = 512;
+        static constexpr uint16_t VERSION = 1;
+
+        PacketRecorder();
+
+        // Start writing all packets to the specified file
+        bool start(const std::string& path);
+        // Close the capture file
+        void stop();
+        // Check if packets are written to a capture file
+        bool is_recording() const;
+
+        // Record a packet received from the server before it is handled
+        void record_inbound(const int8_t* bytes, size_t length);
+        // Record a packet which is sent to the server
+        void record_outbound(const int8_t* bytes, size_t length);
+        // Add the nanoseconds spent handling a packet with the specified opcode
+        void record_handler_time(uint16_t opcode, int64_t time);
+
+        // Return the counters for all opcodes of one direction
+        const std::array<OpcodeStats, NUM_OPCODES>& get_stats(Direction direction) const;
+        // Reset all counters to zero
+        void reset_stats();
+
+    private:
+        void record(Direction direction, const int8_t* bytes, size_t length);
+        void write(Direction direction, const int8_t* bytes, size_t length);
+
+        template <typename T>
+        void write_value(T value) {
+            // Little-endian like the packets themselves
+            file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        std::array<std::array<OpcodeStats, NUM_OPCODES>, NUM_DIRECTIONS> stats;
+
+        std::ofstream file;
+        std::chrono::steady_clock::time_point last;
+    };
+}
@@ -0,0 +1,106 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "PacketReplay.h"
+
+#include "NetConstants.h"
+#include "PacketRecorder.h"
+
+#include "../MapleStory.h"
+
+#include <cstring>
+
+namespace ms {
+    namespace {
+        template <typename T>
+        bool read_value(std::ifstream& file, T& value) {
+            return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+    }
+
+    PacketReplay::PacketReplay() : direction(0), packettime(0), position(0), pending(false) {}
+
+    bool PacketReplay::open(const std::string& path) {
+        file.open(path, std::ios::binary);
+
+        char magic[4];
+        uint16_t version;
+
+        if (!file.read(magic, 4) || std::memcmp(magic, "MSPC", 4) != 0 || !read_value(file, version)
+            || version != PacketRecorder::VERSION) {
+            LOG(LOG_ERROR, "Could not read packet capture [" << path << "]");
+
+            file.close();
+            pending = false;
+
+            return false;
+        }
+
+        packettime = 0;
+        position = 0;
+        pending = read_next();
+
+        return true;
+    }
+
+    size_t PacketReplay::advance(int64_t microseconds, const PacketSwitch& packetswitch) {
+        size_t forwarded = 0;
+        position += microseconds;
+
+        while (pending && packettime <= position) {
+            if (direction == PacketRecorder::INBOUND && !packet.empty()) {
+                packetswitch.forward(packet.data(), packet.size());
+                forwarded++;
+            }
+
+            pending = read_next();
+        }
+
+        return forwarded;
+    }
+
+    bool PacketReplay::finished() const {
+        return !pending;
+    }
+
+    bool PacketReplay::read_next() {
+        uint32_t delta;
+        uint32_t length;
+
+        if (!read_value(file, direction) || !read_value(file, delta) || !read_value(file, length))
+            return false;
+
+        // A corrupt length would otherwise allocate up to 4 GB
+        if (length > MAX_PACKET_LENGTH) {
+            LOG(LOG_ERROR, "Invalid packet capture, a record has length " << length);
+
+            return false;
+        }
+
+        packet.resize(length);
+
+        if (length > 0 && !file.read(reinterpret_cast<char*>(packet.data()), length)) {
+            LOG(LOG_ERROR, "Invalid packet capture, the last record is truncated");
+
+            return false;
+        }
+
+        packettime += delta;
+
+        return true;
+    }
+}
@@ -0,0 +1,53 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "PacketSwitch.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ms {
+    // Feeds the inbound packets of a capture written by 'PacketRecorder' back into a PacketSwitch
+    class PacketReplay {
+    public:
+        PacketReplay();
+
+        // Open a capture file
+        bool open(const std::string& path);
+        // Advance the capture time by the specified microseconds and forward all inbound packets up to it
+        // Return the number of packets forwarded
+        size_t advance(int64_t microseconds, const PacketSwitch& packetswitch);
+        // Check if all packets have been forwarded
+        bool finished() const;
+
+    private:
+        // Read the next record into 'packet', return false at the end of the file or if the record is invalid
+        bool read_next();
+
+        std::ifstream file;
+        std::vector<int8_t> packet;
+        uint8_t direction;
+        // Capture time of the pending packet and the current replay position
+        int64_t packettime;
+        int64_t position;
+        bool pending;
+    };
+}
@@ -16,6 +16,7 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
 //////////////////////////////////////////////////////////////////////////////////
 #include "PacketSwitch.h"
+#include "PacketRecorder.h"
 
 #include "Handlers/AttackHandlers.h"
 #include "Handlers/CashShopHandlers.h"
@@ -30,6 +31,8 @@
 #include "Handlers/SetFieldHandlers.h"
 #include "Handlers/TestingHandlers.h"
 
+#include <chrono>
+
 #include "../Configuration.h"
 
 namespace ms {
@@ -218,11 +221,15 @@ namespace ms {
         // Read the opcode to determine handler responsible
         uint16_t opcode = recv.read_short();
 
+        PacketRecorder& recorder = PacketRecorder::get();
+        recorder.record_inbound(bytes, length);
+
         bool opcode_error = false;
 
         if (opcode < NUM_HANDLERS) {
             if (auto& handler = handlers[opcode]) {
                 // Handler is good, packet is passed on
+                auto start = std::chrono::steady_clock::now();
 
                 try {
                     handler->handle(recv);
@@ -231,6 +238,9 @@ namespace ms {
                     warn(err.what(), opcode);
                     opcode_error = true;
                 }
+
+                auto duration = std::chrono::steady_clock::now() - start;
+                recorder.record_handler_time(opcode, std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
             } else {
                 // Warn about an unhandled packet
                 warn(MSG_UNHANDLED, opcode);
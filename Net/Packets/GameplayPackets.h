@@ -49,11 +49,13 @@ namespace ms {
     // Opcode: MOVE_PLAYER(41)
     class MovePlayerPacket : public MovementPacket {
     public:
-        // Updates the player's position with the server
-        MovePlayerPacket(const Movement& movement) : MovementPacket(MOVE_PLAYER) {
+        // Updates the player's position with the server using a path of several fragments
+        MovePlayerPacket(const std::vector<Movement>& movements) : MovementPacket(MOVE_PLAYER) {
             skip(9);
-            write_byte(1);
-            writemovement(movement);
+            write_byte(static_cast<int8_t>(movements.size()));
+
+            for (const Movement& movement : movements)
+                writemovement(movement);
         }
     };
 
@@ -17,16 +17,33 @@
 //////////////////////////////////////////////////////////////////////////////////
 #include "Session.h"
 
+#include "PacketRecorder.h"
+
 #include "../Configuration.h"
+#include "../Util/Profiler.h"
+
+#include <algorithm>
 
 namespace ms {
-    Session::Session() {
+    namespace {
+        constexpr size_t QUEUESIZE = 1024;
+        // The longest the idle network thread blocks, it is woken up early by received data and written packets
+        constexpr int32_t WAITTIME = 100;
+    }
+
+    Session::Session() : inbound(QUEUESIZE), recycled(QUEUESIZE), outbound(QUEUESIZE) {
         connected = false;
-        length = 0;
-        pos = 0;
+        stats = {};
+        queuedbytes = 0;
+        wakeup = false;
+        running = false;
+        threaded = false;
+        packetbudget = 0;
     }
 
     Session::~Session() {
+        stop_thread();
+
         if (connected)
             socket.close();
     }
@@ -40,6 +57,12 @@ namespace ms {
             cryptography = {socket.get_buffer()};
         }
 
+        // Bytes left over from a previous connection can not be decrypted anymore
+        recvbuffer.clear();
+
+        if (connected && threaded)
+            start_thread();
+
         return connected;
     }
 
@@ -47,6 +70,14 @@ namespace ms {
         std::string HOST = Setting<ServerIP>::get().load();
         std::string PORT = Setting<ServerPort>::get().load();
 
+        threaded = Setting<NetThread>::get().load();
+        packetbudget = Setting<NetPacketBudget>::get().load();
+
+        std::string capture = Setting<PacketCapture>::get().load();
+
+        if (!capture.empty())
+            PacketRecorder::get().start(capture);
+
         if (!init(HOST.c_str(), PORT.c_str()))
             return Error::CONNECTION;
 
@@ -54,6 +85,8 @@ namespace ms {
     }
 
     void Session::reconnect(const char* address, const char* port) {
+        stop_thread();
+
         // Close the current connection and open a new one
         bool success = socket.close();
 
@@ -63,44 +96,49 @@ namespace ms {
             connected = false;
     }
 
-    void Session::process(const int8_t* bytes, size_t available) {
-        if (pos == 0) {
-            // Position is zero, meaning this is the start of a new packet. Start by determining length.
-            length = cryptography.check_length(bytes);
-            // Reading the length means we processed the header. Move forward by the header length.
-            bytes = bytes + HEADER_LENGTH;
-            available -= HEADER_LENGTH;
+    void Session::process() {
+        int8_t* bytes;
+        size_t length;
+
+        while (next_packet(bytes, length)) {
+            stats.packets++;
+
+            forward(bytes, length);
         }
+    }
 
-        // Determine how much we can write. Write data into the buffer.
-        size_t towrite = length - pos;
+    bool Session::next_packet(int8_t*& bytes, size_t& length) {
+        // Only complete packets are returned, an unfinished one stays in the buffer until the rest arrives
+        if (recvbuffer.readable() < HEADER_LENGTH)
+            return false;
 
-        if (towrite > available)
-            towrite = available;
+        int8_t* header = recvbuffer.head();
+        length = cryptography.check_length(header);
 
-        memcpy(buffer + pos, bytes, towrite);
-        pos += towrite;
+        if (length > MAX_PACKET_LENGTH) {
+            LOG(LOG_NETWORK, "Received a packet of length " << length << ", discarding buffered data");
 
-        // Check if the current packet has been fully processed
-        if (pos >= length) {
-            cryptography.decrypt(buffer, length);
+            recvbuffer.clear();
+            return false;
+        }
 
-            try {
-                packetswitch.forward(buffer, length);
-            } catch (const PacketError& err) {
-                LOG(LOG_NETWORK, err.what());
-            }
+        if (recvbuffer.readable() < HEADER_LENGTH + length)
+            return false;
 
-            pos = 0;
-            length = 0;
+        // Decrypt the packet where it was received
+        // It is consumed right away since a handler may reconnect, which clears the buffer
+        bytes = header + HEADER_LENGTH;
+        recvbuffer.consume(HEADER_LENGTH + length);
+        cryptography.decrypt(bytes, length);
 
-            // Check if there is more available
-            size_t remaining = available - towrite;
+        return true;
+    }
 
-            if (remaining >= MIN_PACKET_LENGTH) {
-                // More packets are available, so we start over.
-                process(bytes + towrite, remaining);
-            }
+    void Session::forward(const int8_t* bytes, size_t length) {
+        try {
+            packetswitch.forward(bytes, length);
+        } catch (const PacketError& err) {
+            LOG(LOG_NETWORK, err.what());
         }
     }
 
@@ -108,25 +146,171 @@ namespace ms {
         if (!connected)
             return;
 
-        int8_t header[HEADER_LENGTH];
-        cryptography.create_header(header, packet_length);
-        cryptography.encrypt(packet_bytes, packet_length);
+        int8_t* body = packet_bytes + HEADER_LENGTH;
+        size_t body_length = packet_length - HEADER_LENGTH;
+
+        if (running) {
+            std::vector<int8_t> packet(body, body + body_length);
+
+            while (!outbound.push(std::move(packet)) && running)
+                std::this_thread::yield();
+
+            // Only the first packet since the last flush has to wake up the network thread
+            if (!wakeup.exchange(true))
+                socket.wake();
+
+            return;
+        }
+
+        // Header and body are sent with a single write
+        cryptography.create_header(packet_bytes, body_length);
+        cryptography.encrypt(body, body_length);
 
-        socket.dispatch(header, HEADER_LENGTH);
         socket.dispatch(packet_bytes, packet_length);
     }
 
     void Session::read() {
-        // Check if a packet has arrived. Handle if data is sufficient: 4 bytes (header) + 2 bytes (opcode) = 6 bytes.
-        size_t result = socket.receive(&connected);
+        PROFILE_SCOPE("Session::read");
+
+        stats = {};
+
+        if (threaded) {
+            stats.backlog = queuedbytes;
+
+            // Handle packets queued by the network thread
+            // A budget of zero handles everything that is available
+            std::vector<int8_t> packet;
+
+            while (packetbudget == 0 || stats.packets < packetbudget) {
+                if (!inbound.pop(packet))
+                    break;
+
+                queuedbytes -= packet.size();
+                stats.bytes += packet.size();
+                stats.packets++;
+
+                forward(packet.data(), packet.size());
+
+                recycled.push(std::move(packet));
+            }
+
+            return;
+        }
+
+        // Receive directly into the reassembly buffer
+        bool success = true;
+        recvbuffer.reserve();
+        size_t result = socket.receive(recvbuffer.tail(), recvbuffer.writable(), &success);
+        recvbuffer.commit(result);
+
+        if (!success)
+            connected = false;
 
-        if (result >= MIN_PACKET_LENGTH || length > 0) {
-            // Retrieve buffer from the socket and process it
-            const int8_t* bytes = socket.get_buffer();
-            process(bytes, result);
+        stats.bytes = result;
+        stats.backlog = recvbuffer.readable();
+
+        process();
+    }
+
+    void Session::start_thread() {
+        running = true;
+        netthread = std::thread(&Session::run, this);
+    }
+
+    void Session::stop_thread() {
+        running = false;
+
+        if (netthread.joinable()) {
+            socket.wake();
+            netthread.join();
+        }
+
+        // Packets belonging to the old connection are dropped
+        std::vector<int8_t> packet;
+
+        while (inbound.pop(packet))
+            recycled.push(std::move(packet));
+
+        while (outbound.pop(packet))
+            continue;
+
+        queuedbytes = 0;
+    }
+
+    void Session::run() {
+        while (running) {
+            bool success = true;
+            recvbuffer.reserve();
+            size_t result = socket.receive(recvbuffer.tail(), recvbuffer.writable(), &success);
+            recvbuffer.commit(result);
+
+            if (!success) {
+                connected = false;
+                running = false;
+                break;
+            }
+
+            queue_received();
+
+            wakeup = false;
+
+            bool sent = flush_outbound();
+
+            // Nothing to do, block until data arrives or a packet is written
+            if (result == 0 && !sent)
+                socket.wait(WAITTIME);
         }
     }
 
+    void Session::queue_received() {
+        int8_t* bytes;
+        size_t length;
+
+        while (next_packet(bytes, length)) {
+            std::vector<int8_t> packet;
+            recycled.pop(packet);
+            packet.assign(bytes, bytes + length);
+
+            queuedbytes += length;
+
+            // Wait for the game thread if it has fallen behind
+            while (!inbound.push(std::move(packet))) {
+                if (!running)
+                    return;
+
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool Session::flush_outbound() {
+        sendbatch.clear();
+
+        // Encrypt all waiting packets into one buffer and send them with a single write
+        std::vector<int8_t> packet;
+
+        while (outbound.pop(packet)) {
+            size_t offset = sendbatch.size();
+            size_t length = packet.size();
+
+            sendbatch.resize(offset + HEADER_LENGTH + length);
+            int8_t* header = sendbatch.data() + offset;
+            int8_t* bytes = header + HEADER_LENGTH;
+
+            cryptography.create_header(header, length);
+            std::copy(packet.begin(), packet.end(), bytes);
+            cryptography.encrypt(bytes, length);
+        }
+
+        if (sendbatch.empty())
+            return false;
+
+        if (!socket.dispatch(sendbatch.data(), sendbatch.size()))
+            LOG(LOG_NETWORK, "Failed to send " << sendbatch.size() << " bytes");
+
+        return true;
+    }
+
     void Session::reconnect() {
         std::string HOST = Setting<ServerIP>::get().load();
         std::string PORT = Setting<ServerPort>::get().load();
@@ -137,4 +321,8 @@ namespace ms {
     bool Session::is_connected() const {
         return connected;
     }
+
+    Session::NetStats Session::get_net_stats() const {
+        return stats;
+    }
 }
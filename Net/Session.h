@@ -18,12 +18,17 @@
 #pragma once
 
 #include "Cryptography.h"
+#include "PacketBuffer.h"
 #include "PacketSwitch.h"
 
 #include "../Error.h"
 #include "../MapleStory.h"
 
 #include "../Template/Singleton.h"
+#include "../Template/SpscQueue.h"
+
+#include <atomic>
+#include <thread>
 
 #ifdef USE_ASIO
 #include "SocketAsio.h"
@@ -40,8 +45,10 @@ namespace ms {
         // Connect using host and port from the configuration file
         Error init();
         // Send a packet to the server
+        // The first HEADER_LENGTH bytes of the buffer are reserved for the header, which is filled in here
         void write(int8_t* bytes, size_t length);
         // Check for incoming packets and handle them
+        // If the network thread is used, handles the packets it has queued up to the configured budget
         void read();
         // Closes the current connection and opens a new one with default connection settings
         void reconnect();
@@ -50,17 +57,49 @@ namespace ms {
         // Check if the connection is alive
         bool is_connected() const;
 
+        struct NetStats {
+            size_t bytes;
+            size_t packets;
+            size_t backlog;
+        };
+
+        // Return the bytes received, packets handled and the largest number of buffered bytes during the last read
+        NetStats get_net_stats() const;
+
     private:
         bool init(const char* host, const char* port);
-        void process(const int8_t* bytes, size_t available);
+        void process();
+        bool next_packet(int8_t*& bytes, size_t& length);
+        void forward(const int8_t* bytes, size_t length);
+
+        // Network thread
+        void start_thread();
+        void stop_thread();
+        void run();
+        void queue_received();
+        bool flush_outbound();
 
         Cryptography cryptography;
         PacketSwitch packetswitch;
 
-        int8_t buffer[MAX_PACKET_LENGTH];
-        size_t length;
-        size_t pos;
-        bool connected;
+        PacketBuffer recvbuffer;
+        NetStats stats;
+        std::atomic<bool> connected;
+
+        // Decrypted packets from the network thread, and their buffers once handled
+        SpscQueue<std::vector<int8_t>> inbound;
+        SpscQueue<std::vector<int8_t>> recycled;
+        // Unencrypted packets waiting to be sent by the network thread
+        SpscQueue<std::vector<int8_t>> outbound;
+        std::vector<int8_t> sendbatch;
+        std::atomic<size_t> queuedbytes;
+        // Set once a packet was written since the network thread last flushed the outbound queue
+        std::atomic<bool> wakeup;
+
+        std::thread netthread;
+        std::atomic<bool> running;
+        bool threaded;
+        uint16_t packetbudget;
 
 #ifdef USE_ASIO
 		SocketAsio socket;
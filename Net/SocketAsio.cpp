@@ -18,9 +18,11 @@
 #include "SocketAsio.h"
 
 #ifdef USE_ASIO
+#include <algorithm>
+
 namespace ms
 {
-	SocketAsio::SocketAsio() : resolver(ioservice), socket(ioservice) {}
+	SocketAsio::SocketAsio() : resolver(ioservice), socket(ioservice), wakesocket(ioservice) {}
 
 	SocketAsio::~SocketAsio()
 	{
@@ -41,27 +43,55 @@ namespace ms
 		if (!error)
 		{
 			size_t result = socket.read_some(asio::buffer(buffer), error);
+
+			if (!error && result == HANDSHAKE_LEN)
+				open_wakeup();
+
 			return !error && (result == HANDSHAKE_LEN);
 		}
 
 		return !error;
 	}
 
+	void SocketAsio::open_wakeup()
+	{
+		error_code error;
+
+		// Bind to any free loopback port and connect to it, without a wakeup socket 'wait()' only ends on data or timeout
+		wakesocket.open(udp::v4(), error);
+
+		if (!error)
+			wakesocket.bind(udp::endpoint(asio::ip::address_v4::loopback(), 0), error);
+
+		if (!error)
+			wakesocket.connect(wakesocket.local_endpoint(error), error);
+
+		if (!error)
+			wakesocket.non_blocking(true, error);
+
+		if (error && wakesocket.is_open())
+			wakesocket.close(error);
+	}
+
 	bool SocketAsio::close()
 	{
 		error_code error;
+
+		if (wakesocket.is_open())
+			wakesocket.close(error);
+
 		socket.shutdown(tcp::socket::shutdown_both, error);
 		socket.close(error);
 
 		return !error;
 	}
 
-	size_t SocketAsio::receive(bool* recvok)
+	size_t SocketAsio::receive(int8_t* bytes, size_t length, bool* recvok)
 	{
 		if (socket.available() > 0)
 		{
 			error_code error;
-			size_t result = socket.read_some(asio::buffer(buffer), error);
+			size_t result = socket.read_some(asio::buffer(bytes, length), error);
 			*recvok = !error;
 
 			return result;
@@ -70,6 +100,41 @@ namespace ms
 		return 0;
 	}
 
+	void SocketAsio::wait(int32_t milliseconds)
+	{
+		auto sock = socket.native_handle();
+		auto wakesock = wakesocket.is_open() ? wakesocket.native_handle() : sock;
+
+		timeval timeout = {0, milliseconds * 1000};
+		fd_set sockset;
+
+		FD_ZERO(&sockset);
+		FD_SET(sock, &sockset);
+		FD_SET(wakesock, &sockset);
+
+		int result = ::select(static_cast<int>(std::max(sock, wakesock)) + 1, &sockset, nullptr, nullptr, &timeout);
+
+		if (result > 0 && wakesocket.is_open() && FD_ISSET(wakesock, &sockset))
+		{
+			// Drain all wakeups, the socket is non-blocking
+			error_code error;
+			int8_t bytes[16];
+
+			while (wakesocket.receive(asio::buffer(bytes), 0, error) > 0)
+				continue;
+		}
+	}
+
+	void SocketAsio::wake()
+	{
+		if (wakesocket.is_open())
+		{
+			error_code error;
+			int8_t byte = 0;
+			wakesocket.send(asio::buffer(&byte, 1), 0, error);
+		}
+	}
+
 	const int8_t* SocketAsio::get_buffer() const
 	{
 		return buffer;
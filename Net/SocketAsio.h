@@ -36,6 +36,7 @@ namespace ms
 
 	using asio::io_service;
 	using asio::ip::tcp;
+	using asio::ip::udp;
 	using asio::error_code;
 
 	// Class that wraps an asio socket.
@@ -47,14 +48,22 @@ namespace ms
 
 		bool open(const char* address, const char* port);
 		bool close();
-		size_t receive(bool* connected);
+		size_t receive(int8_t* bytes, size_t length, bool* connected);
+		// Block until data can be received, 'wake()' is called or the timeout passes
+		void wait(int32_t milliseconds);
+		// Return from a 'wait()' on another thread early
+		void wake();
 		const int8_t* get_buffer() const;
 		bool dispatch(const int8_t* bytes, size_t length);
 
 	private:
+		void open_wakeup();
+
 		io_service ioservice;
 		tcp::resolver resolver;
 		tcp::socket socket;
+		// A loopback socket connected to itself, 'wake()' sends a byte to it to end a 'wait()'
+		udp::socket wakesocket;
 		int8_t buffer[MAX_PACKET_LENGTH];
 	};
 }
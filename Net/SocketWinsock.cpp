@@ -27,6 +27,7 @@ namespace ms {
     bool SocketWinsock::open(const char* iaddr, const char* port) {
         WSADATA wsa_info;
         sock = INVALID_SOCKET;
+        wakesock = INVALID_SOCKET;
 
         struct addrinfo* addr_info = nullptr;
         struct addrinfo* ptr = nullptr;
@@ -84,6 +85,8 @@ namespace ms {
         result = recv(sock, (char*)buffer, 32, 0);
 
         if (result == HANDSHAKE_LEN) {
+            open_wakeup();
+
             return true;
         }
         WSACleanup();
@@ -91,7 +94,36 @@ namespace ms {
         return false;
     }
 
+    void SocketWinsock::open_wakeup() {
+        wakesock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+        if (wakesock == INVALID_SOCKET)
+            return;
+
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        int addrlen = sizeof(addr);
+        u_long nonblocking = 1;
+
+        // Bind to any free loopback port and connect to it, without a wakeup socket 'wait()' only ends on data or timeout
+        if (bind(wakesock, (sockaddr*)&addr, addrlen) == SOCKET_ERROR ||
+            getsockname(wakesock, (sockaddr*)&addr, &addrlen) == SOCKET_ERROR ||
+            connect(wakesock, (sockaddr*)&addr, addrlen) == SOCKET_ERROR ||
+            ioctlsocket(wakesock, FIONBIO, &nonblocking) == SOCKET_ERROR) {
+            closesocket(wakesock);
+
+            wakesock = INVALID_SOCKET;
+        }
+    }
+
     bool SocketWinsock::close() {
+        if (wakesock != INVALID_SOCKET) {
+            closesocket(wakesock);
+
+            wakesock = INVALID_SOCKET;
+        }
+
         int error = closesocket(sock);
 
         WSACleanup();
@@ -103,7 +135,7 @@ namespace ms {
         return send(sock, (char*)bytes, static_cast<int>(length), 0) != SOCKET_ERROR;
     }
 
-    size_t SocketWinsock::receive(bool* success) {
+    size_t SocketWinsock::receive(int8_t* bytes, size_t length, bool* success) {
         timeval timeout = {0, 0};
         fd_set sockset = {0};
 
@@ -112,7 +144,7 @@ namespace ms {
         int result = select(0, &sockset, nullptr, nullptr, &timeout);
 
         if (result > 0)
-            result = recv(sock, (char*)buffer, MAX_PACKET_LENGTH, 0);
+            result = recv(sock, (char*)bytes, static_cast<int>(length), 0);
 
         if (result == SOCKET_ERROR) {
             *success = false;
@@ -122,6 +154,33 @@ namespace ms {
         return result;
     }
 
+    void SocketWinsock::wait(int32_t milliseconds) {
+        timeval timeout = {0, milliseconds * 1000};
+        fd_set sockset = {0};
+
+        FD_SET(sock, &sockset);
+
+        if (wakesock != INVALID_SOCKET)
+            FD_SET(wakesock, &sockset);
+
+        int result = select(0, &sockset, nullptr, nullptr, &timeout);
+
+        if (result > 0 && wakesock != INVALID_SOCKET && FD_ISSET(wakesock, &sockset)) {
+            // Drain all wakeups, the socket is non-blocking
+            char bytes[16];
+
+            while (recv(wakesock, bytes, sizeof(bytes), 0) > 0)
+                continue;
+        }
+    }
+
+    void SocketWinsock::wake() {
+        if (wakesock != INVALID_SOCKET) {
+            char byte = 0;
+            send(wakesock, &byte, 1, 0);
+        }
+    }
+
     const int8_t* SocketWinsock::get_buffer() const {
         return buffer;
     }
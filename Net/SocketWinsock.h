@@ -35,11 +35,19 @@ namespace ms {
         bool close();
 
         bool dispatch(const int8_t* bytes, size_t length) const;
-        size_t receive(bool* connected);
+        size_t receive(int8_t* bytes, size_t length, bool* connected);
+        // Block until data can be received, 'wake()' is called or the timeout passes
+        void wait(int32_t milliseconds);
+        // Return from a 'wait()' on another thread early
+        void wake();
         const int8_t* get_buffer() const;
 
     private:
+        void open_wakeup();
+
         uint64_t sock;
+        // A loopback socket connected to itself, 'wake()' sends a byte to it to end a 'wait()'
+        uint64_t wakesock;
         int8_t buffer[MAX_PACKET_LENGTH];
     };
 }
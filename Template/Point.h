@@ -25,6 +25,8 @@
 #include "../Util/WzFiles.h"
 #endif
 
+#include <cmath>
+
 namespace ms {
     template <class T>
     class Point {
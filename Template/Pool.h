@@ -0,0 +1,135 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ms {
+    template <typename T>
+    // Container which keeps up to a fixed number of values packed in one array
+    // Removing moves the last value into the gap, so the order of values is not kept
+    // Memory for all values is reserved when the capacity is set, so adding values never allocates
+    class Pool {
+    public:
+        using iterator = typename std::vector<T>::iterator;
+        using const_iterator = typename std::vector<T>::const_iterator;
+        using size_type = typename std::vector<T>::size_type;
+
+        Pool(size_type limit) : Pool() {
+            set_capacity(limit);
+        }
+
+        // Create a pool without a limit, which grows like a vector until a capacity is set
+        Pool() : capacity(SIZE_MAX), dropped(0) {
+        }
+
+        // Change the maximum number of values and reserve memory for all of them
+        // Values above a lowered maximum are kept until they are removed
+        void set_capacity(size_type value) {
+            capacity = value;
+            values.reserve(value);
+        }
+
+        // Add a value and return a pointer to it
+        // If the pool is full the value is dropped and nullptr is returned
+        template <typename... Args>
+        T* emplace(Args&&... args) {
+            if (values.size() >= capacity) {
+                dropped++;
+
+                return nullptr;
+            }
+
+            values.emplace_back(std::forward<Args>(args)...);
+
+            return &values.back();
+        }
+
+        // Remove all values for which the predicate returns true
+        // The predicate is called exactly once for each value
+        template <typename Predicate>
+        void remove_if(Predicate predicate) {
+            size_type index = 0;
+
+            while (index < values.size()) {
+                if (predicate(values[index])) {
+                    if (index != values.size() - 1)
+                        values[index] = std::move(values.back());
+
+                    values.pop_back();
+                } else {
+                    index++;
+                }
+            }
+        }
+
+        // Remove the value which was added last
+        void pop_back() {
+            values.pop_back();
+        }
+
+        void clear() {
+            values.clear();
+        }
+
+        T& back() {
+            return values.back();
+        }
+
+        size_type size() const {
+            return values.size();
+        }
+
+        bool empty() const {
+            return values.empty();
+        }
+
+        bool full() const {
+            return values.size() >= capacity;
+        }
+
+        // Return the number of values which were dropped because the pool was full
+        size_t get_dropped() const {
+            return dropped;
+        }
+
+        iterator begin() {
+            return values.begin();
+        }
+
+        iterator end() {
+            return values.end();
+        }
+
+        const_iterator begin() const {
+            return values.begin();
+        }
+
+        const_iterator end() const {
+            return values.end();
+        }
+
+    private:
+        std::vector<T> values;
+        size_type capacity;
+        size_t dropped;
+    };
+}
@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ms {
+    template <typename T>
+    // Container which keeps the most recent values up to a fixed capacity
+    // Adding a value to a full buffer replaces the oldest one
+    class RingBuffer {
+    public:
+        // The capacity must not be zero
+        RingBuffer(size_t capacity) : slots(capacity), first(0), count(0) {
+        }
+
+        // Add a value after the newest one and return a reference to it
+        T& push_back(T&& value) {
+            size_t index;
+
+            if (count < slots.size()) {
+                index = wrap(first + count);
+                count++;
+            } else {
+                index = first;
+                first = wrap(first + 1);
+            }
+
+            slots[index] = std::move(value);
+
+            return slots[index];
+        }
+
+        // Return the value at the specified position, zero is the oldest value
+        T& operator[](size_t position) {
+            return slots[wrap(first + position)];
+        }
+
+        const T& operator[](size_t position) const {
+            return slots[wrap(first + position)];
+        }
+
+        // Return the newest value
+        T& back() {
+            return (*this)[count - 1];
+        }
+
+        const T& back() const {
+            return (*this)[count - 1];
+        }
+
+        void clear() {
+            first = 0;
+            count = 0;
+        }
+
+        size_t size() const {
+            return count;
+        }
+
+        size_t capacity() const {
+            return slots.size();
+        }
+
+        bool empty() const {
+            return count == 0;
+        }
+
+    private:
+        size_t wrap(size_t index) const {
+            return index < slots.size() ? index : index - slots.size();
+        }
+
+        std::vector<T> slots;
+        size_t first;
+        size_t count;
+    };
+}
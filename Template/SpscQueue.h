@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+namespace ms {
+    template <typename T>
+    // Bounded queue which one thread pushes to while another thread pops from, without locking
+    class SpscQueue {
+    public:
+        SpscQueue(size_t capacity) : slots(capacity + 1), head(0), tail(0) {
+        }
+
+        // Push a value, returns false if the queue is full
+        // May only be called from the producing thread
+        bool push(T&& value) {
+            size_t current = tail.load(std::memory_order_relaxed);
+            size_t next = advance(current);
+
+            if (next == head.load(std::memory_order_acquire))
+                return false;
+
+            slots[current] = std::move(value);
+            tail.store(next, std::memory_order_release);
+
+            return true;
+        }
+
+        // Pop the oldest value, returns false if the queue is empty
+        // May only be called from the consuming thread
+        bool pop(T& value) {
+            size_t current = head.load(std::memory_order_relaxed);
+
+            if (current == tail.load(std::memory_order_acquire))
+                return false;
+
+            value = std::move(slots[current]);
+            head.store(advance(current), std::memory_order_release);
+
+            return true;
+        }
+
+        bool empty() const {
+            return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+        }
+
+    private:
+        size_t advance(size_t index) const {
+            return index + 1 < slots.size() ? index + 1 : 0;
+        }
+
+        std::vector<T> slots;
+
+        // Kept on separate cache lines so the two threads do not invalidate each other's writes
+        alignas(64) std::atomic<size_t> head;
+        alignas(64) std::atomic<size_t> tail;
+    };
+}
@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <cstring>
+#include <string>
+
+namespace ms {
+    // A string which is borrowed from a buffer that outlives it
+    // Not null-terminated
+    class StringView {
+    public:
+        constexpr StringView(const char* d, size_t s) : first(d), count(s) {
+        }
+
+        constexpr StringView() : StringView(nullptr, 0) {
+        }
+
+        // Return the first character
+        constexpr const char* data() const {
+            return first;
+        }
+
+        // Return the number of characters
+        constexpr size_t size() const {
+            return count;
+        }
+
+        // Check if there are no characters
+        constexpr bool empty() const {
+            return count == 0;
+        }
+
+        // Check if the string begins with the specified characters
+        bool starts_with(const StringView& prefix) const {
+            return count >= prefix.count && StringView(first, prefix.count) == prefix;
+        }
+
+        // Copy the characters into an owning string
+        std::string to_string() const {
+            return std::string(first, count);
+        }
+
+        bool operator ==(const StringView& other) const {
+            return count == other.count && (count == 0 || std::memcmp(first, other.first, count) == 0);
+        }
+
+        bool operator !=(const StringView& other) const {
+            return !(*this == other);
+        }
+
+        bool operator ==(const std::string& other) const {
+            return *this == StringView(other.data(), other.size());
+        }
+
+        bool operator !=(const std::string& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        const char* first;
+        size_t count;
+    };
+}
@@ -0,0 +1,172 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "Profiler.h"
+
+#include "../MapleStory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+namespace ms {
+    Profiler::Profiler() : epoch(std::chrono::steady_clock::now()), enabled(false) {}
+
+    void Profiler::set_enabled(bool value) {
+        enabled.store(value, std::memory_order_relaxed);
+    }
+
+    bool Profiler::is_enabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    int64_t Profiler::now() const {
+        auto duration = std::chrono::steady_clock::now() - epoch;
+
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    }
+
+    void Profiler::record(const char* name, int64_t start, int64_t end) {
+        Ring& ring = local_ring();
+
+        uint64_t head = ring.head.load(std::memory_order_relaxed);
+        Slot& slot = ring.slots[head % CAPACITY];
+
+        // A reader which sees any field of this span also sees a head of at least 'head'
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.start.store(start, std::memory_order_relaxed);
+        slot.duration.store(end - start, std::memory_order_relaxed);
+
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    Profiler::Ring& Profiler::local_ring() {
+        thread_local Ring* ring = nullptr;
+
+        if (!ring) {
+            std::lock_guard<std::mutex> lock(registry);
+
+            rings.push_back(std::make_unique<Ring>());
+            ring = rings.back().get();
+            ring->head = 0;
+            ring->thread = static_cast<uint32_t>(rings.size() - 1);
+        }
+
+        return *ring;
+    }
+
+    std::vector<Profiler::ThreadSpan> Profiler::collect() const {
+        std::vector<ThreadSpan> result;
+        std::lock_guard<std::mutex> lock(registry);
+
+        for (auto& ring : rings) {
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            uint64_t first = head > CAPACITY ? head - CAPACITY : 0;
+            size_t copied = result.size();
+
+            for (uint64_t i = first; i < head; i++) {
+                const Slot& slot = ring->slots[i % CAPACITY];
+
+                result.push_back({
+                    ring->thread, {
+                        slot.name.load(std::memory_order_relaxed),
+                        slot.start.load(std::memory_order_relaxed),
+                        slot.duration.load(std::memory_order_relaxed)
+                    }
+                });
+            }
+
+            // Drop the spans which the owning thread overwrote while they were copied
+            // The slot of span 'after' may already be in the middle of being written, so it is dropped as well
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            uint64_t after = ring->head.load(std::memory_order_relaxed);
+            uint64_t valid = after + 1 > CAPACITY ? after + 1 - CAPACITY : 0;
+
+            if (valid > first) {
+                auto begin = result.begin() + copied;
+                result.erase(begin, begin + std::min(valid, head) - first);
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<Profiler::Summary> Profiler::summarize() const {
+        auto compare = [](const char* a, const char* b) {
+            return std::strcmp(a, b) < 0;
+        };
+
+        std::map<const char*, std::vector<int64_t>, decltype(compare)> durations(compare);
+
+        for (const ThreadSpan& entry : collect())
+            durations[entry.span.name].push_back(entry.span.duration);
+
+        std::vector<Summary> result;
+
+        for (auto& iter : durations) {
+            std::vector<int64_t>& values = iter.second;
+            std::sort(values.begin(), values.end());
+
+            auto percentile = [&values](size_t percent) {
+                return values[(values.size() - 1) * percent / 100];
+            };
+
+            result.push_back({iter.first, values.size(), percentile(50), percentile(90), percentile(99), values.back()});
+        }
+
+        return result;
+    }
+
+    bool Profiler::export_trace(const std::string& path) const {
+        std::ofstream file(path);
+
+        if (!file) {
+            LOG(LOG_ERROR, "Could not write trace to [" << path << "]");
+
+            return false;
+        }
+
+        std::vector<ThreadSpan> spans = collect();
+
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+        for (size_t i = 0; i < spans.size(); i++) {
+            const ThreadSpan& entry = spans[i];
+
+            if (i > 0)
+                file << ',';
+
+            // Chrome expects microseconds
+            file << "{\"name\":\"" << entry.span.name
+                 << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << entry.thread
+                 << ",\"ts\":" << entry.span.start / 1000.0
+                 << ",\"dur\":" << entry.span.duration / 1000.0 << '}';
+        }
+
+        file << "]}";
+
+        LOG(LOG_INFO, "Wrote " << spans.size() << " spans to [" << path << "]");
+
+        return true;
+    }
+}
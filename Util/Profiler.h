@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "../Template/Singleton.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// Record the time until the end of the enclosing scope under the specified name
+// The name must be a string literal
+#define PROFILE_SCOPE(name) ms::Profiler::Scope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+
+namespace ms {
+    // Collects named time spans from all threads
+    // Each thread writes to its own ring buffer without locking, the oldest spans are overwritten
+    class Profiler : public Singleton<Profiler> {
+    public:
+        // A time span in nanoseconds since the profiler was created
+        struct Span {
+            const char* name;
+            int64_t start;
+            int64_t duration;
+        };
+
+        // Percentiles in nanoseconds over the spans currently held for one name
+        struct Summary {
+            const char* name;
+            size_t count;
+            int64_t p50;
+            int64_t p90;
+            int64_t p99;
+            int64_t max;
+        };
+
+        // Records a span from construction to destruction while the profiler is enabled
+        class Scope {
+        public:
+            Scope(const char* name) : name(name) {
+                Profiler& profiler = Profiler::get();
+                start = profiler.is_enabled() ? profiler.now() : -1;
+            }
+
+            ~Scope() {
+                if (start >= 0) {
+                    Profiler& profiler = Profiler::get();
+                    profiler.record(name, start, profiler.now());
+                }
+            }
+
+        private:
+            const char* name;
+            int64_t start;
+        };
+
+        Profiler();
+
+        // Start or stop recording spans
+        void set_enabled(bool enabled);
+        // Check whether spans are recorded
+        bool is_enabled() const;
+        // Return the nanoseconds elapsed since the profiler was created
+        int64_t now() const;
+        // Record a span on the calling thread
+        void record(const char* name, int64_t start, int64_t end);
+
+        // Return the percentiles of all names, sorted by name
+        std::vector<Summary> summarize() const;
+        // Write the spans of all threads as a Chrome trace ('chrome://tracing')
+        bool export_trace(const std::string& path) const;
+
+    private:
+        static constexpr size_t CAPACITY = 8192;
+
+        // A span inside a ring, other threads may read the fields while the owning thread overwrites them
+        struct Slot {
+            std::atomic<const char*> name;
+            std::atomic<int64_t> start;
+            std::atomic<int64_t> duration;
+        };
+
+        struct Ring {
+            std::array<Slot, CAPACITY> slots;
+            // Number of spans written so far, only increased by the owning thread
+            std::atomic<uint64_t> head;
+            uint32_t thread;
+        };
+
+        struct ThreadSpan {
+            uint32_t thread;
+            Span span;
+        };
+
+        Ring& local_ring();
+        // Copy the spans of all threads which were not overwritten while copying
+        std::vector<ThreadSpan> collect() const;
+
+        std::chrono::steady_clock::time_point epoch;
+        std::atomic<bool> enabled;
+
+        // Only locked when a thread records its first span and when reading
+        mutable std::mutex registry;
+        std::vector<std::unique_ptr<Ring>> rings;
+    };
+}
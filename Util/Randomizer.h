@@ -24,6 +24,11 @@ namespace ms {
     // Can be used to generate random numbers.
     class Randomizer {
     public:
+        // Restart the numbers of the calling thread from a fixed seed, so the same calls return the same numbers
+        static void seed(uint32_t value) {
+            engine().seed(value);
+        }
+
         bool next_bool() const {
             return next_int(2) == 1;
         }
@@ -47,10 +52,8 @@ namespace ms {
                 return from;
 
             std::uniform_real_distribution<T> range(from, to);
-            std::random_device rd;
-            std::default_random_engine engine{rd()};
 
-            return range(engine);
+            return range(engine());
         }
 
         template <class T>
@@ -64,10 +67,8 @@ namespace ms {
                 return from;
 
             std::uniform_int_distribution<T> range(from, to - 1);
-            std::random_device rd;
-            std::default_random_engine engine{rd()};
 
-            return range(engine);
+            return range(engine());
         }
 
         template <class E>
@@ -81,5 +82,13 @@ namespace ms {
 
             return static_cast<E>(next_underlying);
         }
+
+    private:
+        // Each thread keeps one engine seeded from the random device
+        static std::default_random_engine& engine() {
+            thread_local std::default_random_engine engine{std::random_device{}()};
+
+            return engine;
+        }
     };
 }
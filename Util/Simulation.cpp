@@ -0,0 +1,323 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#include "Simulation.h"
+
+#include "NxFiles.h"
+#include "Profiler.h"
+#include "Randomizer.h"
+
+#include "../Configuration.h"
+
+#include "../Gameplay/Stage.h"
+#include "../Net/PacketRecorder.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+
+namespace ms {
+    namespace {
+        // Opcodes of the packets used by the script, see 'PacketSwitch'
+        enum Opcode : int16_t {
+            SPAWN_MOB = 0x00EC,
+            KILL_MOB = 0x00ED,
+            MOB_MOVED = 0x00EF,
+            DROP_LOOT = 0x010C,
+            REMOVE_LOOT = 0x010D
+        };
+
+        // The seed used for all random numbers, so that every run is the same
+        constexpr uint32_t SEED = 1;
+        // Mobs are moved every this many ticks, staggered by their oid
+        constexpr uint32_t MOVE_INTERVAL = 30;
+        // All mobs are killed and respawned every this many ticks
+        constexpr uint32_t WAVE_INTERVAL = 600;
+        // Oids of drops are offset from the oids of the mobs dropping them
+        constexpr int32_t DROP_OIDS = 1000000;
+        // The number of opcodes listed in the report
+        constexpr size_t REPORT_OPCODES = 10;
+
+        // Builds the bytes of a packet as sent by the server, starting with the opcode
+        class ScriptPacket {
+        public:
+            ScriptPacket(int16_t opcode) {
+                write_short(opcode);
+            }
+
+            void skip(size_t count) {
+                bytes.insert(bytes.end(), count, 0);
+            }
+
+            void write_byte(int8_t value) {
+                bytes.push_back(value);
+            }
+
+            void write_short(int16_t value) {
+                write_byte(static_cast<int8_t>(value));
+                write_byte(static_cast<int8_t>(value >> 8));
+            }
+
+            void write_int(int32_t value) {
+                write_short(static_cast<int16_t>(value));
+                write_short(static_cast<int16_t>(value >> 16));
+            }
+
+            void write_point(Point<int16_t> point) {
+                write_short(point.x());
+                write_short(point.y());
+            }
+
+            const std::vector<int8_t>& get_bytes() const {
+                return bytes;
+            }
+
+        private:
+            std::vector<int8_t> bytes;
+        };
+
+        int64_t nanoseconds_since(std::chrono::steady_clock::time_point start) {
+            auto duration = std::chrono::steady_clock::now() - start;
+
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        }
+
+        double to_microseconds(int64_t nanoseconds) {
+            return nanoseconds / 1000.0;
+        }
+    }
+
+    Error Simulation::init() {
+        if (Error error = NxFiles::init())
+            return error;
+
+        Char::init();
+        FloatingNumber::init();
+        EffectLayer::init();
+        MapPortals::init();
+        Stage::get().init();
+
+        Randomizer::seed(SEED);
+
+        CharEntry entry = {};
+        entry.id = 1;
+        entry.stats.name = "Simulation";
+        entry.stats.stats[MapleStat::Id::LEVEL] = 1;
+        entry.stats.stats[MapleStat::Id::HP] = 50;
+        entry.stats.stats[MapleStat::Id::MAXHP] = 50;
+        entry.look.hairid = 30000;
+        entry.look.faceid = 20000;
+
+        mobid = Setting<SimulationMob>::get().load();
+        num_mobs = Setting<SimulationMobs>::get().load();
+        capture = Setting<SimulationCapture>::get().load();
+        speed = Setting<SimulationSpeed>::get().load();
+
+        if (!capture.empty() && !replay.open(capture))
+            return Error(Error::Code::MISSING_FILE, capture.c_str());
+
+        Stage::get().loadplayer(entry);
+        Stage::get().load(Setting<SimulationMap>::get().load(), 0);
+
+        return Error::Code::NONE;
+    }
+
+    void Simulation::run() {
+        uint32_t ticks = Setting<SimulationTicks>::get().load();
+        bool profiling = Setting<Profiling>::get().load();
+
+        Profiler::get().set_enabled(profiling);
+
+        std::array<int64_t, Stage::NUM_SUBSYSTEMS> total = {};
+        std::array<int64_t, Stage::NUM_SUBSYSTEMS> worst = {};
+        int64_t packet_time = 0;
+        int64_t total_update = 0;
+        int64_t worst_update = 0;
+
+        PacketRecorder::get().reset_stats();
+
+        for (uint32_t tick = 0; tick < ticks; ++tick) {
+            auto start = std::chrono::steady_clock::now();
+
+            if (capture.empty())
+                script(tick);
+            else
+                replay.advance(static_cast<int64_t>(Constants::TIMESTEP) * 1000 * speed, packet_switch);
+
+            packet_time += nanoseconds_since(start);
+
+            start = std::chrono::steady_clock::now();
+            Stage::get().update();
+            int64_t update_time = nanoseconds_since(start);
+
+            total_update += update_time;
+            worst_update = std::max(worst_update, update_time);
+
+            const auto& times = Stage::get().get_update_times();
+
+            for (size_t i = 0; i < Stage::NUM_SUBSYSTEMS; ++i) {
+                total[i] += times[i];
+                worst[i] = std::max(worst[i], times[i]);
+            }
+        }
+
+        if (profiling)
+            Profiler::get().export_trace("simulation.json");
+
+        if (ticks == 0)
+            return;
+
+        if (capture.empty())
+            std::cout << "Simulated " << ticks << " ticks with " << num_mobs << " mobs (us per tick, mean / max)" << std::endl;
+        else
+            std::cout << "Replayed " << ticks << " ticks of [" << capture << "] (us per tick, mean / max)" << std::endl;
+
+        std::cout << "Packets: " << to_microseconds(packet_time / ticks) << std::endl;
+        std::cout << "Update: " << to_microseconds(total_update / ticks) << " / " << to_microseconds(worst_update) << std::endl;
+
+        for (size_t i = 0; i < Stage::NUM_SUBSYSTEMS; ++i)
+            std::cout << "    " << Stage::nameof(static_cast<Stage::Subsystem>(i)) << ": " << to_microseconds(total[i] / ticks) << " / " << to_microseconds(worst[i]) << std::endl;
+
+        report_opcodes();
+    }
+
+    void Simulation::report_opcodes() const {
+        const auto& stats = PacketRecorder::get().get_stats(PacketRecorder::Direction::INBOUND);
+
+        std::vector<uint16_t> opcodes;
+
+        for (uint16_t opcode = 0; opcode < PacketRecorder::NUM_OPCODES; ++opcode)
+            if (stats[opcode].count > 0)
+                opcodes.push_back(opcode);
+
+        std::sort(opcodes.begin(), opcodes.end(), [&stats](uint16_t a, uint16_t b) {
+            return stats[a].time > stats[b].time;
+        });
+
+        if (opcodes.size() > REPORT_OPCODES)
+            opcodes.resize(REPORT_OPCODES);
+
+        std::cout << "Opcodes (count, bytes, us handling)" << std::endl;
+
+        for (uint16_t opcode : opcodes)
+            std::cout << "    0x" << std::hex << opcode << std::dec << ": " << stats[opcode].count << ", " << stats[opcode].bytes << ", " << to_microseconds(stats[opcode].time) << std::endl;
+    }
+
+    void Simulation::script(uint32_t tick) {
+        uint32_t wave = tick % WAVE_INTERVAL;
+
+        for (int32_t oid = 1; oid <= num_mobs; ++oid) {
+            if (wave == 0) {
+                remove_drop(DROP_OIDS + oid);
+                spawn_mob(oid);
+            } else if (wave == WAVE_INTERVAL - 1) {
+                drop_meso(DROP_OIDS + oid, Stage::get().get_mobs().get_mob_position(oid));
+                kill_mob(oid);
+            } else if ((wave + oid) % MOVE_INTERVAL == 0) {
+                move_mob(oid, tick);
+            }
+        }
+    }
+
+    void Simulation::spawn_mob(int32_t oid) {
+        ScriptPacket packet(SPAWN_MOB);
+        packet.write_int(oid);
+        packet.write_byte(5);
+        packet.write_int(mobid);
+        packet.skip(16);
+        packet.write_point(position_of(oid, 0));
+        packet.write_byte(Mob::value_of(Mob::Stance::STAND, oid % 2 == 0));
+        packet.skip(2);
+        packet.write_short(0);
+        packet.write_byte(0);
+        packet.write_byte(0);
+        packet.skip(4);
+
+        forward(packet.get_bytes());
+    }
+
+    void Simulation::move_mob(int32_t oid, uint32_t tick) {
+        Point<int16_t> position = Stage::get().get_mobs().get_mob_position(oid);
+        Point<int16_t> destination = position_of(oid, tick);
+        bool flip = destination.x() > position.x();
+
+        ScriptPacket packet(MOB_MOVED);
+        packet.write_int(oid);
+        packet.skip(7);
+        packet.write_point(position);
+
+        // One relative movement towards the destination
+        packet.write_byte(1);
+        packet.write_byte(1);
+        packet.write_short(destination.x() - position.x());
+        packet.write_short(0);
+        packet.write_byte(Mob::value_of(Mob::Stance::MOVE, flip));
+        packet.write_short(MOVE_INTERVAL * Constants::TIMESTEP);
+
+        forward(packet.get_bytes());
+    }
+
+    void Simulation::kill_mob(int32_t oid) {
+        ScriptPacket packet(KILL_MOB);
+        packet.write_int(oid);
+        packet.write_byte(1);
+
+        forward(packet.get_bytes());
+    }
+
+    void Simulation::drop_meso(int32_t oid, Point<int16_t> position) {
+        // Mesos are used since the sounds of item drops require audio
+        ScriptPacket packet(DROP_LOOT);
+        packet.write_byte(1);
+        packet.write_int(oid);
+        packet.write_byte(1);
+        packet.write_int(oid % 1000 + 1);
+        packet.write_int(0);
+        packet.write_byte(0);
+        packet.write_point(position);
+        packet.skip(4);
+        packet.write_point(position);
+        packet.skip(2);
+        packet.write_byte(1);
+
+        forward(packet.get_bytes());
+    }
+
+    void Simulation::remove_drop(int32_t oid) {
+        ScriptPacket packet(REMOVE_LOOT);
+        packet.write_byte(0);
+        packet.write_int(oid);
+
+        forward(packet.get_bytes());
+    }
+
+    Point<int16_t> Simulation::position_of(int32_t oid, uint32_t tick) const {
+        Range<int16_t> walls = Stage::get().get_map_info().get_walls();
+        int16_t width = std::max<int16_t>(walls.delta(), 1);
+
+        uint32_t hash = static_cast<uint32_t>(oid) * 2654435761u + tick * 40503u;
+        int16_t x = walls.first() + static_cast<int16_t>(hash % width);
+        int16_t y = Stage::get().get_player().get_position().y();
+
+        return {x, y};
+    }
+
+    void Simulation::forward(const std::vector<int8_t>& bytes) {
+        packet_switch.forward(bytes.data(), bytes.size());
+    }
+}
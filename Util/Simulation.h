@@ -0,0 +1,66 @@
+//////////////////////////////////////////////////////////////////////////////////
+//	This file is part of the continued Journey MMORPG client					//
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton						//
+//																				//
+//	This program is free software: you can redistribute it and/or modify		//
+//	it under the terms of the GNU Affero General Public License as published by	//
+//	the Free Software Foundation, either version 3 of the License, or			//
+//	(at your option) any later version.											//
+//																				//
+//	This program is distributed in the hope that it will be useful,				//
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of				//
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the				//
+//	GNU Affero General Public License for more details.							//
+//																				//
+//	You should have received a copy of the GNU Affero General Public License	//
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.		//
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "../Error.h"
+
+#include "../Net/PacketReplay.h"
+#include "../Net/PacketSwitch.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ms {
+    // Runs the stage without a window, audio or server connection
+    // A map is loaded from the game files and a fixed script of packets spawns, moves and kills mobs and drops loot
+    // Alternatively the inbound packets of a capture are replayed
+    // After the configured number of ticks the average and worst time of each part of 'Stage::update()' is written to the console
+    class Simulation {
+    public:
+        // Load the game files, a default character and the configured map
+        Error init();
+        // Run the script for the configured number of fixed timesteps and print the timings
+        void run();
+
+    private:
+        // Forward the scripted packets for the specified tick
+        void script(uint32_t tick);
+        // Print the opcodes which took the longest to handle
+        void report_opcodes() const;
+
+        void spawn_mob(int32_t oid);
+        void move_mob(int32_t oid, uint32_t tick);
+        void kill_mob(int32_t oid);
+        void drop_meso(int32_t oid, Point<int16_t> position);
+        void remove_drop(int32_t oid);
+
+        // Return a position on the player's platform which only depends on the oid and tick
+        Point<int16_t> position_of(int32_t oid, uint32_t tick) const;
+
+        void forward(const std::vector<int8_t>& bytes);
+
+        PacketSwitch packet_switch;
+        PacketReplay replay;
+        std::string capture;
+        uint16_t speed;
+
+        int32_t mobid;
+        uint16_t num_mobs;
+    };
+}